@@ -0,0 +1,96 @@
+#----------------------------------------------------------------------------+
+# HMDQ Tools - tools for VR headsets and other hardware introspection        |
+# https://github.com/risa2000/hmdq                                           |
+#                                                                            |
+# Copyright (c) 2026, Richard Musil. All rights reserved.                    |
+#                                                                            |
+# This source code is licensed under the BSD 3-Clause "New" or "Revised"     |
+# License found in the LICENSE file in the root directory of this project.   |
+# SPDX-License-Identifier: BSD-3-Clause                                      |
+#----------------------------------------------------------------------------+
+
+# Generate the OpenVR API table (tracked device properties and classes) from the OpenVR
+# API JSON definition file. Run as a script:
+#   cmake -DOAPI_JSON=<openvr_api.json> -DOAPI_TABLE_IN=<template> -DOAPI_TABLE=<output>
+#         -P oapitable.cmake
+
+cmake_minimum_required (VERSION 3.19)
+
+# property types known to `basevr::PropType`
+set (PROP_TYPES
+    Float Double Int16 Uint16 Int32 Uint32 Int64 Uint64 Bool String
+    Vector2 Vector3 Vector4 Matrix33 Matrix34 Matrix44 Quaternion Quad
+    )
+
+# Return the property type from its name (e.g. "Prop_DisplayFrequency_Float")
+function (prop_type pname out_var)
+    string (REGEX MATCH "_([A-Za-z0-9]+)(_Array)?$" match "${pname}")
+    set (ptype "Invalid")
+    if (match)
+        list (FIND PROP_TYPES "${CMAKE_MATCH_1}" found)
+        if (NOT found EQUAL -1)
+            set (ptype "${CMAKE_MATCH_1}")
+        endif()
+    endif()
+    set (${out_var} "basevr::PropType::${ptype}" PARENT_SCOPE)
+endfunction()
+
+# Split the property name into the base name and the type name the same way as
+# `basevr::parse_prop_name` (e.g. "Prop_DisplayAvailableFrameRates_Float_Array" ->
+# "DisplayAvailableFrameRates", "Float_Array", true)
+function (prop_name_parts pname base_var type_var array_var)
+    if (pname MATCHES "^[^_]*_(.*)_([^_]+_Array)$")
+        set (is_array "true")
+    elseif (pname MATCHES "^[^_]*_(.*)_([^_]+)$")
+        set (is_array "false")
+    elseif (pname MATCHES "^[^_]*_(.*)$")
+        set (CMAKE_MATCH_2 "${CMAKE_MATCH_1}")
+        set (is_array "false")
+    else()
+        message (FATAL_ERROR "Invalid property name: ${pname}")
+    endif()
+    set (${base_var} "${CMAKE_MATCH_1}" PARENT_SCOPE)
+    set (${type_var} "${CMAKE_MATCH_2}" PARENT_SCOPE)
+    set (${array_var} "${is_array}" PARENT_SCOPE)
+endfunction()
+
+file (READ "${OAPI_JSON}" oapi)
+string (JSON enums GET "${oapi}" enums)
+string (JSON enums_len LENGTH "${enums}")
+math (EXPR enums_last "${enums_len} - 1")
+
+set (OAPI_PROPS "")
+set (OAPI_CLASSES "")
+set (OAPI_PROPS_SIZE 0)
+set (OAPI_CLASSES_SIZE 0)
+foreach (i RANGE ${enums_last})
+    string (JSON enum GET "${enums}" ${i})
+    string (JSON enum_name GET "${enum}" enumname)
+    if (NOT enum_name STREQUAL "vr::ETrackedDeviceProperty"
+        AND NOT enum_name STREQUAL "vr::ETrackedDeviceClass")
+        continue()
+    endif()
+    string (JSON values GET "${enum}" values)
+    string (JSON values_len LENGTH "${values}")
+    math (EXPR values_last "${values_len} - 1")
+    foreach (j RANGE ${values_last})
+        string (JSON name GET "${values}" ${j} name)
+        string (JSON value GET "${values}" ${j} value)
+        if (enum_name STREQUAL "vr::ETrackedDeviceProperty")
+            math (EXPR cat "${value} / 1000")
+            prop_type ("${name}" ptype)
+            prop_name_parts ("${name}" base tname is_array)
+            string (APPEND OAPI_PROPS "    {${value}, ${cat}, \"${name}\", \"${base}\", "
+                    "\"${tname}\", ${ptype}, ${is_array}},\n")
+            math (EXPR OAPI_PROPS_SIZE "${OAPI_PROPS_SIZE} + 1")
+        else()
+            # drop the "TrackedDeviceClass_" prefix
+            string (REGEX REPLACE "^[^_]*_" "" name "${name}")
+            string (APPEND OAPI_CLASSES "    {${value}, \"${name}\"},\n")
+            math (EXPR OAPI_CLASSES_SIZE "${OAPI_CLASSES_SIZE} + 1")
+        endif()
+    endforeach()
+endforeach()
+
+get_filename_component (OAPI_JSON_NAME "${OAPI_JSON}" NAME)
+configure_file ("${OAPI_TABLE_IN}" "${OAPI_TABLE}" @ONLY)
@@ -0,0 +1,463 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#include <common/archive.h>
+#include <common/except.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstring>
+#include <iterator>
+#include <unordered_map>
+
+//  locals
+//------------------------------------------------------------------------------
+static constexpr char ARCHIVE_MAGIC[] = "HMDQARCH";
+static constexpr char ENTRY_MAGIC[] = "HMDE";
+static constexpr size_t ARCHIVE_MAGIC_SIZE = sizeof(ARCHIVE_MAGIC) - 1;
+static constexpr size_t ENTRY_MAGIC_SIZE = sizeof(ENTRY_MAGIC) - 1;
+static constexpr uint32_t ARCHIVE_VER = 1;
+
+//  header, entry header and index record sizes
+static constexpr size_t HEADER_SIZE = 32;
+static constexpr size_t ENTRY_HEADER_SIZE = 16;
+static constexpr size_t RECORD_SIZE = 32;
+
+//  Archive header
+struct ArchiveHeader {
+    uint64_t index_offset = 0;
+    uint64_t count = 0;
+};
+
+//  functions
+//------------------------------------------------------------------------------
+static void put_u32(char* p, uint32_t val)
+{
+    for (size_t i = 0; i < sizeof(val); ++i) {
+        p[i] = static_cast<char>((val >> (8 * i)) & 0xff);
+    }
+}
+
+static void put_u64(char* p, uint64_t val)
+{
+    for (size_t i = 0; i < sizeof(val); ++i) {
+        p[i] = static_cast<char>((val >> (8 * i)) & 0xff);
+    }
+}
+
+static uint32_t get_u32(const char* p)
+{
+    uint32_t val = 0;
+    for (size_t i = 0; i < sizeof(val); ++i) {
+        val |= static_cast<uint32_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+    }
+    return val;
+}
+
+static uint64_t get_u64(const char* p)
+{
+    uint64_t val = 0;
+    for (size_t i = 0; i < sizeof(val); ++i) {
+        val |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+    }
+    return val;
+}
+
+//  Return the encoded archive header.
+static std::array<char, HEADER_SIZE> encode_header(const ArchiveHeader& hdr)
+{
+    std::array<char, HEADER_SIZE> res{};
+    std::memcpy(res.data(), ARCHIVE_MAGIC, ARCHIVE_MAGIC_SIZE);
+    put_u32(res.data() + 8, ARCHIVE_VER);
+    put_u64(res.data() + 16, hdr.index_offset);
+    put_u64(res.data() + 24, hdr.count);
+    return res;
+}
+
+//  Decode and check the archive header, `size` is the archive size.
+static ArchiveHeader decode_header(const char* data, uint64_t size,
+                                   const std::filesystem::path& apath)
+{
+    if (size < HEADER_SIZE
+        || std::memcmp(data, ARCHIVE_MAGIC, ARCHIVE_MAGIC_SIZE) != 0) {
+        throw hmdq_error(fmt::format("Not an archive: \"{}\"", path_to_utf8(apath)));
+    }
+    const auto ver = get_u32(data + 8);
+    if (ver != ARCHIVE_VER) {
+        throw hmdq_error(fmt::format("Unsupported archive version {}: \"{}\"", ver,
+                                     path_to_utf8(apath)));
+    }
+    ArchiveHeader hdr{get_u64(data + 16), get_u64(data + 24)};
+    if (hdr.index_offset > size || hdr.count > (size - hdr.index_offset) / RECORD_SIZE) {
+        throw hmdq_error(fmt::format("Corrupted archive: \"{}\"", path_to_utf8(apath)));
+    }
+    return hdr;
+}
+
+//  Encode the index record.
+static std::array<char, RECORD_SIZE> encode_record(const ArchiveRecord& rec)
+{
+    std::array<char, RECORD_SIZE> res{};
+    put_u64(res.data(), rec.meta_offset);
+    put_u64(res.data() + 8, rec.meta_size);
+    put_u64(res.data() + 16, rec.data_offset);
+    put_u64(res.data() + 24, rec.data_size);
+    return res;
+}
+
+//  Decode the index record.
+static ArchiveRecord decode_record(const char* p)
+{
+    return {get_u64(p), get_u64(p + 8), get_u64(p + 16), get_u64(p + 24)};
+}
+
+//  Return true if the string is a (non-negative) number.
+static bool is_number(const std::string& str)
+{
+    return !str.empty() && std::all_of(str.begin(), str.end(), [](unsigned char c) {
+        return std::isdigit(c);
+    });
+}
+
+//  Return the archives open in the process (by their absolute path) with their lock.
+static auto& open_archives()
+{
+    static struct {
+        std::mutex mtx;
+        std::unordered_map<std::string, std::weak_ptr<const Archive>> archives;
+    } s_open;
+    return s_open;
+}
+
+//  Return the key of the archive in the open archives.
+static std::string archive_key(const std::filesystem::path& apath)
+{
+    return path_to_utf8(std::filesystem::absolute(apath).lexically_normal());
+}
+
+//  Return true if the archive is open in the process.
+static bool is_open_archive(const std::filesystem::path& apath)
+{
+    auto& open = open_archives();
+    std::lock_guard lock(open.mtx);
+    const auto it = open.archives.find(archive_key(apath));
+    return it != open.archives.end() && !it->second.expired();
+}
+
+//  Return the archive shared by all its users in the process.
+std::shared_ptr<const Archive> open_archive(const std::filesystem::path& apath)
+{
+    const auto key = archive_key(apath);
+    auto& open = open_archives();
+    std::lock_guard lock(open.mtx);
+    auto parc = open.archives[key].lock();
+    if (!parc) {
+        // drop the closed ones before adding the new one
+        for (auto it = open.archives.begin(); it != open.archives.end();) {
+            it = (it->first != key && it->second.expired()) ? open.archives.erase(it)
+                                                            : std::next(it);
+        }
+        parc = std::make_shared<const Archive>(apath);
+        open.archives[key] = parc;
+    }
+    return parc;
+}
+
+//  Return true if the file is an archive.
+bool is_archive(const std::filesystem::path& path)
+{
+    std::array<char, ARCHIVE_MAGIC_SIZE> magic{};
+    std::ifstream fin(path, std::ios::binary);
+    fin.read(magic.data(), magic.size());
+    return fin && std::memcmp(magic.data(), ARCHIVE_MAGIC, magic.size()) == 0;
+}
+
+//  Split the archive path and the entry selector.
+bool split_archive_path(const std::filesystem::path& path, std::filesystem::path& apath,
+                        std::string& selector)
+{
+    if (std::filesystem::is_regular_file(path)) {
+        if (!is_archive(path)) {
+            return false;
+        }
+        apath = path;
+        selector.clear();
+        return true;
+    }
+    // the first separator after an existing archive (the selector may contain one too)
+    const auto u8path = path_to_utf8(path);
+    for (auto pos = u8path.find(ARCHIVE_SEP); pos != std::string::npos;
+         pos = u8path.find(ARCHIVE_SEP, pos + 1)) {
+        const auto arc = utf8_to_path(u8path.substr(0, pos));
+        // the open archive is known, do not check the file for each entry
+        if (is_open_archive(arc)
+            || (std::filesystem::is_regular_file(arc) && is_archive(arc))) {
+            apath = arc;
+            selector = u8path.substr(pos + 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+//  Return the path of the archive entry.
+std::filesystem::path archive_entry_path(const std::filesystem::path& apath, size_t i)
+{
+    auto res = apath;
+    res += utf8_to_path(fmt::format("{}{}", ARCHIVE_SEP, i));
+    return res;
+}
+
+//  Archive class
+//------------------------------------------------------------------------------
+Archive::Archive(const std::filesystem::path& apath)
+    : m_path(apath)
+    , m_mfile(apath)
+{
+    std::vector<char> buffer;
+    const char* hdata = nullptr;
+    if (m_mfile.is_mapped()) {
+        m_data = m_mfile.data();
+        m_size = m_mfile.size();
+        hdata = m_data;
+    } else {
+        m_file.open(apath, std::ios::binary);
+        if (!m_file) {
+            throw hmdq_error(
+                fmt::format("Cannot open archive: \"{}\"", path_to_utf8(apath)));
+        }
+        m_size = std::filesystem::file_size(apath);
+        buffer = read_range(0, std::min<uint64_t>(m_size, HEADER_SIZE));
+        hdata = buffer.data();
+    }
+    const auto hdr = decode_header(hdata, m_size, apath);
+
+    // load the index and check that all entries are inside the archive
+    const auto isize = hdr.count * RECORD_SIZE;
+    if (m_data) {
+        hdata = m_data + hdr.index_offset;
+    } else {
+        buffer = read_range(hdr.index_offset, isize);
+        hdata = buffer.data();
+    }
+    m_index.reserve(static_cast<size_t>(hdr.count));
+    for (uint64_t pos = 0; pos < isize; pos += RECORD_SIZE) {
+        const auto rec = decode_record(hdata + pos);
+        if (rec.meta_offset > m_size || rec.meta_size > m_size - rec.meta_offset
+            || rec.data_offset > m_size || rec.data_size > m_size - rec.data_offset) {
+            throw hmdq_error(
+                fmt::format("Corrupted archive: \"{}\"", path_to_utf8(apath)));
+        }
+        m_index.push_back(rec);
+    }
+}
+
+//  Return the index record of the entry.
+const ArchiveRecord& Archive::record(size_t i) const
+{
+    if (i >= m_index.size()) {
+        throw hmdq_error(fmt::format("Archive entry {} out of range ({} entries): \"{}\"",
+                                     i, m_index.size(), path_to_utf8(m_path)));
+    }
+    return m_index[i];
+}
+
+//  Read the range from the archive file.
+std::vector<char> Archive::read_range(uint64_t offset, uint64_t size) const
+{
+    HMDQ_ASSERT(!m_data);
+    std::vector<char> res(static_cast<size_t>(size));
+    std::lock_guard lock(m_mtx);
+    m_file.seekg(offset);
+    m_file.read(res.data(), res.size());
+    if (!m_file) {
+        // keep the stream usable for the other entries
+        m_file.clear();
+        throw hmdq_error(
+            fmt::format("Cannot read archive: \"{}\"", path_to_utf8(m_path)));
+    }
+    return res;
+}
+
+//  Return the metadata of the entry.
+json Archive::meta(size_t i) const
+{
+    const auto& rec = record(i);
+    if (m_data) {
+        const auto first = m_data + rec.meta_offset;
+        return json::parse(first, first + rec.meta_size);
+    }
+    const auto buffer = read_range(rec.meta_offset, rec.meta_size);
+    return json::parse(buffer.cbegin(), buffer.cend());
+}
+
+//  Return the entries matching the selector.
+std::vector<size_t> Archive::select(const std::string& selector) const
+{
+    std::vector<size_t> res;
+    if (is_number(selector)) {
+        const auto i = std::stoull(selector);
+        // check the range
+        record(i);
+        res.push_back(i);
+        return res;
+    }
+    // parse the filter (comma separated "key=value" pairs)
+    std::vector<std::pair<std::string, std::string>> filter;
+    for (size_t first = 0; first < selector.size();) {
+        const auto last = std::min(selector.find(',', first), selector.size());
+        const auto item = selector.substr(first, last - first);
+        const auto eq = item.find('=');
+        if (eq == std::string::npos || eq == 0) {
+            throw hmdq_error(fmt::format("Invalid archive selector: \"{}\"", selector));
+        }
+        filter.emplace_back(item.substr(0, eq), item.substr(eq + 1));
+        first = last + 1;
+    }
+    for (size_t i = 0, e = m_index.size(); i < e; ++i) {
+        if (filter.empty()) {
+            res.push_back(i);
+            continue;
+        }
+        // only the metadata of the entry is read
+        const auto jmeta = meta(i);
+        const auto match = std::all_of(filter.begin(), filter.end(), [&jmeta](auto& kv) {
+            const auto it = jmeta.find(kv.first);
+            return it != jmeta.end() && it->is_string()
+                && it->template get<std::string>() == kv.second;
+        });
+        if (match) {
+            res.push_back(i);
+        }
+    }
+    return res;
+}
+
+//  Return the only entry matching the selector.
+size_t Archive::select_one(const std::string& selector) const
+{
+    const auto res = select(selector);
+    if (res.size() != 1) {
+        throw hmdq_error(fmt::format("Archive selector \"{}\" matches {} entries: \"{}\"",
+                                     selector, res.size(), path_to_utf8(m_path)));
+    }
+    return res.front();
+}
+
+//  ArchiveWriter class
+//------------------------------------------------------------------------------
+ArchiveWriter::ArchiveWriter(const std::filesystem::path& apath)
+    : m_path(apath)
+{
+    if (!std::filesystem::exists(apath)) {
+        std::ofstream fout(apath, std::ios::binary);
+        const auto hdr = encode_header({});
+        fout.write(hdr.data(), hdr.size());
+        if (!fout) {
+            throw hmdq_error(
+                fmt::format("Cannot create archive: \"{}\"", path_to_utf8(apath)));
+        }
+    }
+    m_file.open(apath, std::ios::in | std::ios::out | std::ios::binary);
+    if (!m_file) {
+        throw hmdq_error(fmt::format("Cannot open archive: \"{}\"", path_to_utf8(apath)));
+    }
+
+    // read the existing index
+    std::array<char, HEADER_SIZE> hbuf{};
+    m_file.read(hbuf.data(), hbuf.size());
+    const auto size = std::filesystem::file_size(apath);
+    const auto hdr = decode_header(hbuf.data(), m_file ? size : 0, apath);
+    m_file.seekg(hdr.index_offset);
+    m_index.reserve(hdr.count);
+    std::array<char, RECORD_SIZE> rbuf{};
+    for (uint64_t i = 0; i < hdr.count; ++i) {
+        m_file.read(rbuf.data(), rbuf.size());
+        m_index.push_back(decode_record(rbuf.data()));
+    }
+    if (!m_file) {
+        throw hmdq_error(fmt::format("Corrupted archive: \"{}\"", path_to_utf8(apath)));
+    }
+    m_committed = m_index.size();
+    m_end = size;
+}
+
+//  Throw if the last write failed.
+void ArchiveWriter::check_write()
+{
+    if (!m_file) {
+        throw hmdq_error(
+            fmt::format("Cannot write archive: \"{}\"", path_to_utf8(m_path)));
+    }
+}
+
+//  Flush the written data to the disk.
+void ArchiveWriter::sync()
+{
+    if (!flush_file(m_path)) {
+        throw hmdq_error(
+            fmt::format("Cannot flush archive: \"{}\"", path_to_utf8(m_path)));
+    }
+}
+
+//  Append the entry.
+void ArchiveWriter::append(const json& meta, const char* first, const char* last)
+{
+    const auto smeta = meta.dump();
+    ArchiveRecord rec;
+    rec.meta_offset = m_end + ENTRY_HEADER_SIZE;
+    rec.meta_size = smeta.size();
+    rec.data_offset = rec.meta_offset + rec.meta_size;
+    rec.data_size = static_cast<uint64_t>(last - first);
+
+    std::array<char, ENTRY_HEADER_SIZE> ebuf{};
+    std::memcpy(ebuf.data(), ENTRY_MAGIC, ENTRY_MAGIC_SIZE);
+    put_u32(ebuf.data() + 4, static_cast<uint32_t>(rec.meta_size));
+    put_u64(ebuf.data() + 8, rec.data_size);
+    m_file.seekp(m_end);
+    m_file.write(ebuf.data(), ebuf.size());
+    m_file.write(smeta.data(), smeta.size());
+    m_file.write(first, last - first);
+    check_write();
+
+    m_index.push_back(rec);
+    m_end = rec.data_offset + rec.data_size;
+}
+
+//  Write the new index and update the header.
+void ArchiveWriter::commit()
+{
+    if (m_committed == m_index.size()) {
+        return;
+    }
+    const ArchiveHeader hdr{m_end, m_index.size()};
+    m_file.seekp(m_end);
+    for (const auto& rec : m_index) {
+        const auto rbuf = encode_record(rec);
+        m_file.write(rbuf.data(), rbuf.size());
+    }
+    // the entries and the index must be on the disk before the header points to them
+    m_file.flush();
+    check_write();
+    sync();
+    m_end += m_index.size() * RECORD_SIZE;
+
+    const auto hbuf = encode_header(hdr);
+    m_file.seekp(0);
+    m_file.write(hbuf.data(), hbuf.size());
+    m_file.flush();
+    check_write();
+    sync();
+    m_committed = m_index.size();
+}
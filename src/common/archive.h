@@ -0,0 +1,160 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <common/json_proxy.h>
+#include <common/wintools.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//  Append-only archive of data files. It starts with a fixed header pointing to the
+//  offset index, each entry is a small metadata header (compact JSON object) followed
+//  by the unchanged data file. The new entries and the new index are always appended
+//  and only the header is rewritten at the end, so an interrupted append leaves the
+//  archive as it was (the old indexes stay in the file as unused space).
+//
+//  Layout (all integers are little-endian):
+//      header: "HMDQARCH", u32 version, u32 reserved, u64 index offset, u64 entries
+//      entry:  "HMDE", u32 meta size, u64 data size, meta, data
+//      index:  entries * (u64 meta offset, u64 meta size, u64 data offset, u64 data size)
+
+//  globals
+//------------------------------------------------------------------------------
+//  Separator of the archive path and the entry selector ("<archive>#<selector>")
+constexpr char ARCHIVE_SEP = '#';
+
+//  typedefs
+//------------------------------------------------------------------------------
+//  Archive index record (the metadata and the data position of one entry)
+struct ArchiveRecord {
+    uint64_t meta_offset = 0;
+    uint64_t meta_size = 0;
+    uint64_t data_offset = 0;
+    uint64_t data_size = 0;
+};
+
+//  Read-only (memory mapped) archive. The entries are addressed by their index or by
+//  a metadata filter, without reading the data of the other entries. If the archive
+//  cannot be mapped, only the index is loaded and each entry is read from the file on
+//  demand. All methods are safe to call from multiple threads.
+class Archive
+{
+  public:
+    explicit Archive(const std::filesystem::path& apath);
+    Archive(const Archive&) = delete;
+    Archive& operator=(const Archive&) = delete;
+
+  public:
+    //  Return the number of the entries.
+    size_t size() const
+    {
+        return m_index.size();
+    }
+    //  Return the metadata of the entry.
+    json meta(size_t i) const;
+    //  Call `func(first, last)` over the data of the entry and return its result. The
+    //  range points into the mapped archive, or into the buffer with only this entry
+    //  read from the file.
+    template <typename F>
+    auto with_data(size_t i, F&& func) const
+    {
+        const auto& rec = record(i);
+        if (m_data) {
+            const auto first = m_data + rec.data_offset;
+            return func(first, first + rec.data_size);
+        }
+        const auto buffer = read_range(rec.data_offset, rec.data_size);
+        return func(buffer.data(), buffer.data() + buffer.size());
+    }
+
+    //  Return the entries matching the selector, which is either the entry index (e.g.
+    //  "12"), or the metadata filter (e.g. "model=Index,hmdq_ver=2.1.0"), or empty (for
+    //  all entries).
+    std::vector<size_t> select(const std::string& selector) const;
+    //  Return the only entry matching the selector (throw if there is none or more).
+    size_t select_one(const std::string& selector) const;
+
+  private:
+    //  Return the index record of the entry.
+    const ArchiveRecord& record(size_t i) const;
+    //  Read [offset, offset + size) from the archive file (if it is not mapped).
+    std::vector<char> read_range(uint64_t offset, uint64_t size) const;
+
+  private:
+    std::filesystem::path m_path;
+    MappedFile m_mfile;
+    // the archive file if it cannot be mapped
+    mutable std::ifstream m_file;
+    mutable std::mutex m_mtx;
+    const char* m_data = nullptr;
+    uint64_t m_size = 0;
+    std::vector<ArchiveRecord> m_index;
+};
+
+//  Appends the entries to the archive (creates it if it does not exist). The appended
+//  entries are added to the archive index only by `commit`.
+class ArchiveWriter
+{
+  public:
+    explicit ArchiveWriter(const std::filesystem::path& apath);
+
+  public:
+    //  Return the number of the entries (including the appended ones).
+    size_t size() const
+    {
+        return m_index.size();
+    }
+    //  Append the entry with its metadata (JSON object) and the data in [first, last).
+    void append(const json& meta, const char* first, const char* last);
+    //  Write the new index and update the header (if there are new entries).
+    void commit();
+
+  private:
+    //  Throw if the last write failed.
+    void check_write();
+    //  Flush the written data to the disk.
+    void sync();
+
+  private:
+    std::filesystem::path m_path;
+    std::fstream m_file;
+    std::vector<ArchiveRecord> m_index;
+    // the entries in the written index
+    size_t m_committed = 0;
+    // the end of the archive (the next entry position)
+    uint64_t m_end = 0;
+};
+
+//  functions
+//------------------------------------------------------------------------------
+//  Return the archive shared by all its users in the process. The archive stays open
+//  while any of them holds it, so the entries read meanwhile do not open and map it
+//  again. It must not be appended to while open.
+std::shared_ptr<const Archive> open_archive(const std::filesystem::path& apath);
+
+//  Return true if the file is an archive.
+bool is_archive(const std::filesystem::path& path);
+
+//  If the path is an archive (then the selector is empty) or an archive with the entry
+//  selector ("<archive>#<selector>"), store the archive path and the selector, and
+//  return true.
+bool split_archive_path(const std::filesystem::path& path, std::filesystem::path& apath,
+                        std::string& selector);
+
+//  Return the path of the archive entry ("<archive>#<index>").
+std::filesystem::path archive_entry_path(const std::filesystem::path& apath, size_t i);
@@ -24,6 +24,7 @@
 class BaseVRProcessor;
 class BaseVRCollector;
 class BaseVRConfig;
+class ThreadPool;
 
 //  typedefs
 //------------------------------------------------------------------------------
@@ -89,7 +90,10 @@ class BaseVRProcessor : public BaseVR
     // Initialize the VR subsystem data processor
     virtual bool init() = 0;
     // Calculate complementary data
-    virtual void calculate() = 0;
+    // profile: number of FOV profile samples (0 = no FOV profile)
+    virtual void calculate(size_t profile) = 0;
+    // Calculate complementary data, the independent parts run as tasks in the pool
+    virtual void calculate(ThreadPool& pool, size_t profile) = 0;
     // Anonymize sensitive data
     virtual void anonymize() = 0;
     // Print the collected data
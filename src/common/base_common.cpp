@@ -81,6 +81,52 @@ parse_prop_name(const std::string& pname)
     return {basename, type_name, ptype_from_ptypename(ptype), is_array};
 }
 
+//  Property descriptor index
+//------------------------------------------------------------------------------
+PropIndex::PropIndex(const std::unordered_map<std::string, int>& verb_props, int vmax)
+    : m_verbs(verb_props)
+    , m_vmax(vmax)
+{}
+
+//  Add the property (if not already there) and return its descriptor.
+const PropDesc& PropIndex::add(const std::string& pname, int pid)
+{
+    // parse the name only for a new property
+    if (const auto pdesc = find(pname)) {
+        return *pdesc;
+    }
+    auto [basename, ptype_name, ptype, is_array] = parse_prop_name(pname);
+    PropDesc pdesc;
+    pdesc.name = pname;
+    pdesc.pid = pid;
+    pdesc.basename = std::move(basename);
+    pdesc.type_name = std::move(ptype_name);
+    pdesc.ptype = ptype;
+    pdesc.is_array = is_array;
+    return add(std::move(pdesc));
+}
+
+//  Add the already parsed property descriptor (if not already there) and return
+//  the stored one.
+const PropDesc& PropIndex::add(PropDesc pdesc)
+{
+    auto [it, added] = m_index.try_emplace(pdesc.name);
+    if (added) {
+        const auto vit = m_verbs.find(pdesc.name);
+        pdesc.verb = (vit != m_verbs.end()) ? vit->second : m_vmax;
+        it->second = std::move(pdesc);
+        m_props.push_back(&it->second);
+    }
+    return it->second;
+}
+
+//  Return the property descriptor, or nullptr if the property is not in the index.
+const PropDesc* PropIndex::find(const std::string& pname) const
+{
+    const auto it = m_index.find(pname);
+    return (it != m_index.end()) ? &it->second : nullptr;
+}
+
 //  Print property functions.
 //------------------------------------------------------------------------------
 //  Print the property name to stdout.
@@ -97,13 +143,11 @@ inline void prop_head_out(int pid, const std::string& name, bool is_array, int i
 }
 
 //  Print (non-error) value of an Array type property.
-void print_array_type(const std::string& pname, const json& pval, int ind, int ts)
+void print_array_type(const PropDesc& pdesc, const json& pval, int ind, int ts)
 {
     const auto sf = ind * ts;
-    // parse the name to get the type
-    const auto [basename, ptype_name, ptype, is_array] = parse_prop_name(pname);
 
-    switch (ptype) {
+    switch (pdesc.ptype) {
         case PropType::Float:
             print_tensor<double, 1>(pval.get<hvector_t>(), ind, ts);
             break;
@@ -132,58 +176,79 @@ void print_array_type(const std::string& pname, const json& pval, int ind, int t
             print_tensor<double, 2>(pval.get<xt::xtensor<double, 2>>(), ind, ts);
             break;
         default:
-            const auto msg = fmt::format(MSG_TYPE_NOT_IMPL, ptype_name);
+            const auto msg = fmt::format(MSG_TYPE_NOT_IMPL, pdesc.type_name);
             iprint(sf, ERR_MSG_FMT_JSON, msg);
             break;
     }
 }
 
-std::vector<std::string> format_pval(PropType ptype, const json& pval)
+//  Format the property value into the buffer, return false if the type is not supported.
+bool format_pval(fmt::memory_buffer& buf, PropType ptype, const json& pval)
 {
+    const auto out = std::back_inserter(buf);
     switch (ptype) {
         case PropType::Bool:
-            return {fmt::format("{}", pval.get<bool>())};
+            fmt::format_to(out, "{}", pval.get<bool>());
+            return true;
         case PropType::String:
-            return {fmt::format("\"{:s}\"", pval.get<std::string>())};
+            fmt::format_to(out, "\"{:s}\"", pval.get<std::string>());
+            return true;
         case PropType::Int16:
-            return {fmt::format("{}", pval.get<int16_t>())};
+            fmt::format_to(out, "{}", pval.get<int16_t>());
+            return true;
         case PropType::Uint16:
-            return {fmt::format("{:#06x}", pval.get<uint16_t>())};
+            fmt::format_to(out, "{:#06x}", pval.get<uint16_t>());
+            return true;
         case PropType::Int32:
-            return {fmt::format("{}", pval.get<int32_t>())};
+            fmt::format_to(out, "{}", pval.get<int32_t>());
+            return true;
         case PropType::Uint32:
-            return {fmt::format("{:#010x}", pval.get<uint32_t>())};
+            fmt::format_to(out, "{:#010x}", pval.get<uint32_t>());
+            return true;
         case PropType::Int64:
-            return {fmt::format("{}", pval.get<int64_t>())};
+            fmt::format_to(out, "{}", pval.get<int64_t>());
+            return true;
         case PropType::Uint64:
-            return {fmt::format("{:#018x}", pval.get<uint64_t>())};
+            fmt::format_to(out, "{:#018x}", pval.get<uint64_t>());
+            return true;
         case PropType::Float:
         case PropType::Double:
-            return {fmt::format("{}", pval.get<double>())};
+            fmt::format_to(out, "{}", pval.get<double>());
+            return true;
         case PropType::Vector2:
         case PropType::Vector3:
         case PropType::Vector4: {
-            return format_tensor<double, 1>(pval.get<hvector_t>());
+            format_tensor<double, 1>(buf, pval.get<hvector_t>());
+            return true;
         }
         case PropType::Matrix34:
         case PropType::Matrix44: {
-            return format_tensor<double, 2>(pval.get<harray2d_t>());
+            format_tensor<double, 2>(buf, pval.get<harray2d_t>());
+            return true;
         }
         default:
-            return {};
+            return false;
+    }
+}
+
+//  Return true if the (non-array) property value is printed on multiple lines.
+inline bool is_multiline(PropType ptype)
+{
+    switch (ptype) {
+        case PropType::Matrix33:
+        case PropType::Matrix34:
+        case PropType::Matrix44:
+            return true;
+        default:
+            return false;
     }
 }
 
 //  Print one property out (do not print PID < 0)
-void print_one_prop(const std::string& pname, const json& pval, int pid,
-                    const json& verb_props, int verb, int ind, int ts)
+void print_one_prop(const PropDesc& pdesc, const json& pval, int pid, int verb, int ind,
+                    int ts)
 {
-    const auto sf = ind * ts;
-    const auto jverb = g_cfg[j_verbosity];
-    const auto verr = jverb[j_error].get<int>();
-    const auto vmax = jverb[j_max].get<int>();
-    // decode property type
-    const auto [basename, ptype_name, ptype, is_array] = parse_prop_name(pname);
+    const auto verr = g_cfgs.verb.error;
     // property verbosity level (if defined) or max
     int pverb;
     // property having an error attached?
@@ -194,14 +259,8 @@ void print_one_prop(const std::string& pname, const json& pval, int pid,
         // is at 'error' level
         pverb = verr;
     } else {
-        // determine the "active" verbosity level for the current property
-        if (verb_props.contains(pname)) {
-            // explicitly defined property
-            pverb = verb_props[pname].get<int>();
-        } else {
-            // otherwise set requested verbosity to vmax
-            pverb = vmax;
-        }
+        // the "active" verbosity level for the current property
+        pverb = pdesc.verb;
     }
     if (verb < pverb) {
         // do not print props which require higher verbosity than the current one
@@ -209,23 +268,25 @@ void print_one_prop(const std::string& pname, const json& pval, int pid,
     }
 
     // print the prop name
-    prop_head_out(pid, basename, is_array, ind, ts);
+    prop_head_out(pid, pdesc.basename, pdesc.is_array, ind, ts);
     if (nerr) {
         const auto msg = get_error_msg(pval);
-        fmt::print(ERR_MSG_FMT_JSON, msg);
-    } else if (is_array) {
-        fmt::print("\n");
-        print_array_type(pname, pval, ind + 1, ts);
+        oprint(ERR_MSG_FMT_JSON, msg);
+    } else if (pdesc.is_array) {
+        oprint("\n");
+        print_array_type(pdesc, pval, ind + 1, ts);
     } else {
-        const auto fval = format_pval(ptype, pval);
-        if (fval.size() == 1) {
-            fmt::print("{}\n", fval[0]);
-        } else if (fval.size() > 1) {
-            fmt::print("\n");
+        fmt::memory_buffer buf;
+        const auto ok = format_pval(buf, pdesc.ptype, pval);
+        const std::string_view fval(buf.data(), buf.size());
+        if (!ok) {
+            const auto msg = fmt::format(MSG_TYPE_NOT_IMPL, pdesc.type_name);
+            oprint(ERR_MSG_FMT_JSON, msg);
+        } else if (is_multiline(pdesc.ptype)) {
+            oprint("\n");
             print_multiline(fval, ind + 1, ts);
         } else {
-            const auto msg = fmt::format(MSG_TYPE_NOT_IMPL, ptype_name);
-            fmt::print(ERR_MSG_FMT_JSON, msg);
+            oprint("{}\n", fval);
         }
     }
 }
@@ -15,6 +15,8 @@
 
 #include <string>
 #include <tuple>
+#include <unordered_map>
+#include <vector>
 
 namespace basevr {
 
@@ -50,6 +52,49 @@ enum class PropType : int {
     Quad,
 };
 
+//  Property descriptor (the parsed property name with its id and verbosity level)
+struct PropDesc {
+    std::string name; // full property name
+    int pid = -1; // property id (-1 if not defined)
+    std::string basename;
+    std::string type_name;
+    PropType ptype = PropType::Invalid;
+    bool is_array = false;
+    int verb = 0; // verbosity level needed to print the property
+};
+
+//  Property descriptor index
+//------------------------------------------------------------------------------
+//  Hashed index of property descriptors (by the property name). The property names are
+//  parsed only once, when added to the index.
+class PropIndex
+{
+  public:
+    //  Explicit verbosity levels are in `verb_props` (from the config snapshot, which
+    //  must outlive the index), all other properties get `vmax`.
+    PropIndex(const std::unordered_map<std::string, int>& verb_props, int vmax);
+
+  public:
+    //  Add the property (if not already there) and return its descriptor.
+    const PropDesc& add(const std::string& pname, int pid = -1);
+    //  Add the already parsed property descriptor (if not already there) and return
+    //  the stored one. The verbosity level is set by the index.
+    const PropDesc& add(PropDesc pdesc);
+    //  Return the property descriptor, or nullptr if the property is not in the index.
+    const PropDesc* find(const std::string& pname) const;
+    //  Return all property descriptors in the order they were added.
+    const std::vector<const PropDesc*>& props() const
+    {
+        return m_props;
+    }
+
+  private:
+    const std::unordered_map<std::string, int>& m_verbs;
+    int m_vmax;
+    std::unordered_map<std::string, PropDesc> m_index;
+    std::vector<const PropDesc*> m_props;
+};
+
 //  Generic functions.
 //------------------------------------------------------------------------------
 //  Return {<str:base_name>, <str:type_name>, <enum:type>, <bool:array>}
@@ -59,7 +104,7 @@ parse_prop_name(const std::string& pname);
 //  Print functions.
 //------------------------------------------------------------------------------
 //  Print one property out (do not print PID < 0)
-void print_one_prop(const std::string& pname, const json& pval, int pid,
-                    const json& verb_props, int verb, int ind, int ts);
+void print_one_prop(const PropDesc& pdesc, const json& pval, int pid, int verb, int ind,
+                    int ts);
 
 } // namespace basevr
@@ -17,6 +17,7 @@
 #include <common/json_proxy.h>
 #include <common/jtools.h>
 #include <common/optmesh.h>
+#include <common/tpool.h>
 #include <common/xtdef.h>
 
 #include <xtensor/xarray.hpp>
@@ -24,15 +25,21 @@
 #include <xtensor/xjson.hpp>
 #include <xtensor/xview.hpp>
 
+#include <array>
+#include <future>
+#include <memory>
+#include <tuple>
+#include <vector>
+
 //  functions
 //------------------------------------------------------------------------------
 //  load or build verts and faces from recorded data
-std::tuple<harray2d_t, hfaces_t, bool> calc_resolve_verts_and_faces(const json& ham_mesh)
+std::tuple<harray2d_t, hcfaces_t, bool> calc_resolve_verts_and_faces(const json& ham_mesh)
 {
     // vertices = three consecutive vertices define one triangle
     harray2d_t verts;
     // faces (corresponding to verts) either built or collected
-    hfaces_t faces;
+    hcfaces_t faces;
     // faces raw computed or recorded?
     bool faces_computed = false;
 
@@ -53,226 +60,393 @@ std::tuple<harray2d_t, hfaces_t, bool> calc_resolve_verts_and_faces(const json&
         // number of vertices must be divisible by 3 as each 3 defined one triangle
         HMDQ_ASSERT(verts.shape(0) % 3 == 0);
         // build the trivial faces for the triangles
-        for (size_t i = 0, e = verts.shape(0); i < e; i += 3) {
-            faces.push_back(hface_t({i, i + 1, i + 2}));
+        HMDQ_ASSERT(std::in_range<hindex_t>(verts.shape(0)));
+        const auto nverts = static_cast<hindex_t>(verts.shape(0));
+        faces.reserve(nverts / 3, nverts);
+        for (hindex_t i = 0; i < nverts; i += 3) {
+            faces.push_back({i, i + 1, i + 2});
         }
         faces_computed = true;
     } else {
-        faces = ham_mesh[j_faces].get<hfaces_t>();
+        faces = ham_mesh[j_faces].get<hcfaces_t>();
     }
     return {verts, faces, faces_computed};
 }
 
-//  Calculate optimized HAM mesh topology
-json calc_opt_ham_mesh(const json& ham_mesh)
+//  Parse raw eye frustum from JSON
+RawEye parse_raw_eye(const json& raw)
+{
+    return {raw[j_tan_left].get<double>(), raw[j_tan_right].get<double>(),
+            raw[j_tan_bottom].get<double>(), raw[j_tan_top].get<double>()};
+}
+
+//  Parse HAM mesh from JSON (only the recorded data and the area are loaded)
+HamMesh parse_ham_mesh(const json& ham_mesh)
 {
+    HamMesh res;
     // resolve or rebuild verts and faces from collected data
-    const auto& [verts_raw, faces_raw, faces_raw_computed]
+    std::tie(res.verts_raw, res.faces_raw, res.faces_raw_computed)
         = calc_resolve_verts_and_faces(ham_mesh);
+    if (ham_mesh.contains(j_ham_area) && ham_mesh[j_ham_area].is_number()) {
+        res.ham_area = ham_mesh[j_ham_area].get<double>();
+    }
+    return res;
+}
 
-    // reduce duplicated vertices
-    const auto& [verts_opt, n_faces] = reduce_verts(verts_raw, faces_raw);
+//  Parse eye FOV from JSON
+EyeFov parse_eye_fov(const json& fov)
+{
+    EyeFov res;
+    res.fov_pts = fov[j_fov_pts].get<harray2d_t>();
+    res.deg_left = fov[j_deg_left].get<double>();
+    res.deg_right = fov[j_deg_right].get<double>();
+    res.deg_bottom = fov[j_deg_bottom].get<double>();
+    res.deg_top = fov[j_deg_top].get<double>();
+    // older files may not have the aggregated values
+    res.deg_hor = fov.value(j_deg_hor, res.deg_right - res.deg_left);
+    res.deg_ver = fov.value(j_deg_ver, res.deg_top - res.deg_bottom);
+    if (fov.contains(j_fov_profile)) {
+        res.fov_profile = fov[j_fov_profile].get<std::vector<double>>();
+    }
+    return res;
+}
 
-    // do final faces optimization
-    const auto faces_opt = reduce_faces(n_faces);
+//  Parse geometry input data from JSON
+Geometry parse_geometry(const json& jd)
+{
+    Geometry res;
+    const std::array<const char*, EYES> eyes = {j_leye, j_reye};
+    for (size_t i = 0; i < EYES; ++i) {
+        res.raw_eye[i] = parse_raw_eye(jd[j_raw_eye][eyes[i]]);
+        res.eye2head[i] = jd[j_eye2head][eyes[i]].get<harray2d_t>();
+        // the mesh section may be missing, or miss (or have null) the eye entry
+        if (jd.contains(j_ham_mesh) && jd[j_ham_mesh].contains(eyes[i])
+            && !jd[j_ham_mesh][eyes[i]].is_null()) {
+            res.ham_mesh[i] = parse_ham_mesh(jd[j_ham_mesh][eyes[i]]);
+        }
+    }
+    return res;
+}
 
-    // build the resulting JSON
+//  Serialize HAM mesh into JSON
+json ham_mesh_to_json(const HamMesh& mesh)
+{
     json res;
 
-    // preserve calculated area
-    if (ham_mesh.contains(j_ham_area)) {
-        res[j_ham_area] = ham_mesh[j_ham_area];
+    // put a stub here if the area is not calculated, so the later assignment will not
+    // add it to the end of the section
+    if (mesh.ham_area) {
+        res[j_ham_area] = *mesh.ham_area;
     } else {
-        // if just running from new put a stub here so the later assignment will not add
-        // it to the end of the section
         res[j_ham_area] = nullptr;
     }
 
-    if (verts_raw != verts_opt) {
+    if (mesh.verts_raw != mesh.verts_opt) {
         // save 'verts_raw' only if they differ from the optimized version
-        res[j_verts_raw] = verts_raw;
+        res[j_verts_raw] = mesh.verts_raw;
     }
-    if (faces_raw != faces_opt && !faces_raw_computed) {
+    if (mesh.faces_raw != mesh.faces_opt && !mesh.faces_raw_computed) {
         // save 'faces_raw' only if they differ from the optimized version
-        res[j_faces_raw] = faces_raw;
+        res[j_faces_raw] = mesh.faces_raw;
+    }
+    res[j_verts_opt] = mesh.verts_opt;
+    res[j_faces_opt] = mesh.faces_opt;
+
+    return res;
+}
+
+//  Serialize eye FOV into JSON
+json eye_fov_to_json(const EyeFov& fov)
+{
+    json res;
+    json fov_pts = fov.fov_pts;
+    res[j_fov_pts] = fov_pts;
+    res[j_deg_left] = fov.deg_left;
+    res[j_deg_right] = fov.deg_right;
+    res[j_deg_bottom] = fov.deg_bottom;
+    res[j_deg_top] = fov.deg_top;
+    res[j_deg_hor] = fov.deg_hor;
+    res[j_deg_ver] = fov.deg_ver;
+    if (!fov.fov_profile.empty()) {
+        res[j_fov_profile] = fov.fov_profile;
+    }
+    return res;
+}
+
+//  Serialize total FOV into JSON
+json total_fov_to_json(const TotalFov& fov)
+{
+    return json({{j_fov_hor, fov.fov_hor},
+                 {j_fov_ver, fov.fov_ver},
+                 {j_fov_diag, fov.fov_diag},
+                 {j_overlap, fov.overlap}});
+}
+
+//  Serialize the geometry into JSON, `jd` is the original geometry object from which
+//  the properties not covered by `Geometry` are copied.
+json geometry_to_json(const Geometry& geom, const json& jd)
+{
+    const std::array<const char*, EYES> eyes = {j_leye, j_reye};
+    json fov_eye;
+    json fov_head;
+    json ham_mesh;
+
+    for (size_t i = 0; i < EYES; ++i) {
+        if (geom.fov_eye[i]) {
+            fov_eye[eyes[i]] = eye_fov_to_json(*geom.fov_eye[i]);
+        }
+        fov_head[eyes[i]] = eye_fov_to_json(geom.fov_head[i]);
+        ham_mesh[eyes[i]]
+            = geom.ham_mesh[i] ? ham_mesh_to_json(*geom.ham_mesh[i]) : json();
+    }
+
+    // create a new object to ensure the right order of the newly inserted objects
+    json res;
+    // copy first only certain properties and only if they exist.
+    // At the moment, it only concerns Oculus specific j_render_desc.
+    for (const auto& name : {j_rec_rts, j_raw_eye, j_eye2head, j_render_desc}) {
+        if (jd.contains(name)) {
+            res[name] = jd[name];
+        }
     }
-    res[j_verts_opt] = verts_opt;
-    res[j_faces_opt] = faces_opt;
+    res[j_view_geom] = json({{j_left_rot, geom.view_geom.left_rot},
+                             {j_right_rot, geom.view_geom.right_rot},
+                             {j_ipd, geom.view_geom.ipd}});
+    res[j_fov_eye] = fov_eye;
+    res[j_fov_head] = fov_head;
+    res[j_fov_tot] = total_fov_to_json(geom.fov_tot);
+    res[j_ham_mesh] = ham_mesh;
 
     return res;
 }
 
 //  Calculate optimized HAM mesh topology
-double calc_ham_area(const json& ham_mesh)
+void calc_opt_ham_mesh(HamMesh& mesh)
+{
+    // reduce duplicated vertices
+    std::tie(mesh.verts_opt, mesh.faces_opt)
+        = reduce_verts(mesh.verts_raw, mesh.faces_raw);
+
+    // do final faces optimization
+    mesh.faces_opt = reduce_faces(mesh.faces_opt);
+}
+
+//  Calculate optimized HAM mesh topology
+json calc_opt_ham_mesh(const json& ham_mesh)
+{
+    auto mesh = parse_ham_mesh(ham_mesh);
+    calc_opt_ham_mesh(mesh);
+    return ham_mesh_to_json(mesh);
+}
+
+//  Calculate HAM area
+double calc_ham_area(const HamMesh& mesh, ClipStats* stats)
+{
+    return area_mesh_tris_idx_clip(mesh.verts_raw, mesh.faces_raw, stats);
+}
+
+//  Calculate HAM area
+double calc_ham_area(const json& ham_mesh, ClipStats* stats)
 {
     // resolve or rebuild verts and faces from collected data
     const auto& [verts_raw, faces_raw, faces_raw_computed]
         = calc_resolve_verts_and_faces(ham_mesh);
 
-    return area_mesh_tris_idx_geos(verts_raw, faces_raw);
+    return area_mesh_tris_idx_clip(verts_raw, faces_raw, stats);
+}
+
+//  Prepare the frustum mesh (HAM lifted into the frustum) to be shared by multiple
+//  FOV calculations of the same eye.
+geom::FrustumMesh calc_frustum_mesh(const RawEye& raw, const HamMesh* mesh)
+{
+    if (nullptr != mesh) {
+        // the optimized vertices are read in place
+        return geom::FrustumMesh(raw.left, raw.right, raw.bottom, raw.top,
+                                 mesh->verts_opt, geom::faces_to_edges(mesh->faces_opt));
+    }
+    return geom::FrustumMesh(raw.left, raw.right, raw.bottom, raw.top);
 }
 
-//  Calculate partial FOVs for the projection (new version).
-json calc_fov(const json& raw, const json& mesh, const harray2d_t* rot)
+//  Calculate partial FOVs for the projection from the prepared frustum mesh.
+EyeFov calc_fov(const geom::FrustumMesh& fmesh, const harray2d_t* rot, size_t profile)
 {
-    std::unique_ptr<geom::Meshd> pHam;
     std::unique_ptr<geom::Rotation> pRot;
 
-    if (!mesh.is_null()) {
-        const harray2d_t verts = mesh[j_verts_opt];
-        const hfaces_t faces = mesh[j_faces_opt];
-        hedgelist_t edges = geom::faces_to_edges(faces);
-        pHam = std::make_unique<geom::Meshd>(verts, edges);
-    }
     if (nullptr != rot) {
         const auto rotMat
             = Eigen::Map<const Eigen::Matrix<double, 3, 3, Eigen::RowMajor>>(rot->data());
         pRot = std::make_unique<geom::Rotation>(rotMat);
     }
-    auto frustum
-        = geom::Frustum(raw[j_tan_left].get<double>(), raw[j_tan_right].get<double>(),
-                        raw[j_tan_bottom].get<double>(), raw[j_tan_top].get<double>(),
-                        pRot.get(), pHam.get());
+    auto frustum = geom::Frustum(fmesh, pRot.get());
 
-    harray2d_t pts = frustum.get_fov_points(true);
+    EyeFov res;
+    res.fov_pts = frustum.get_fov_points(true);
 
     // calculate angles
     std::vector<double> deg_pts;
     const hvector_t base = {0, 0, -1};
-    for (size_t i = 0, e = pts.shape(0); i < e; ++i) {
-        const auto p = xt::view(pts, i);
+    for (size_t i = 0, e = res.fov_pts.shape(0); i < e; ++i) {
+        const auto p = xt::view(res.fov_pts, i);
         deg_pts.push_back(angle_deg(base, p));
     }
 
-    json res;
-    json fov_pts = pts;
-    res[j_fov_pts] = fov_pts;
-    res[j_deg_left] = -deg_pts[7];
-    res[j_deg_right] = deg_pts[3];
-    res[j_deg_bottom] = -deg_pts[1];
-    res[j_deg_top] = deg_pts[5];
-    res[j_deg_hor] = deg_pts[3] + deg_pts[7];
-    res[j_deg_ver] = deg_pts[1] + deg_pts[5];
+    res.deg_left = -deg_pts[7];
+    res.deg_right = deg_pts[3];
+    res.deg_bottom = -deg_pts[1];
+    res.deg_top = deg_pts[5];
+    res.deg_hor = deg_pts[3] + deg_pts[7];
+    res.deg_ver = deg_pts[1] + deg_pts[5];
+
+    // FOV profile: the angle from the view axis at evenly spaced polar angles
+    // (counter-clockwise, starting at the right direction)
+    if (profile > 0) {
+        const harray2d_t prof_pts = frustum.get_fov_profile(profile, true);
+        res.fov_profile.reserve(profile);
+        for (size_t i = 0, e = prof_pts.shape(0); i < e; ++i) {
+            const auto p = xt::view(prof_pts, i);
+            res.fov_profile.push_back(angle_deg(base, p));
+        }
+    }
 
     return res;
 }
 
 //  Calculate total, vertical, horizontal and diagonal FOVs.
-json calc_total_fov(const json& fov_head)
+TotalFov calc_total_fov(const std::array<EyeFov, EYES>& fov_head)
 {
+    const auto& left = fov_head[LEYE];
+    const auto& right = fov_head[REYE];
+
+    TotalFov res;
     // horizontal FOV
-    const auto fov_hor = fov_head[j_reye][j_deg_right].get<double>()
-        - fov_head[j_leye][j_deg_left].get<double>();
+    res.fov_hor = right.deg_right - left.deg_left;
 
     // vertical FOV calculated from "straight ahead" look
-    const auto ver_right = fov_head[j_reye][j_deg_top].get<double>()
-        - fov_head[j_reye][j_deg_bottom].get<double>();
-    const auto ver_left = fov_head[j_leye][j_deg_top].get<double>()
-        - fov_head[j_leye][j_deg_bottom].get<double>();
-    const auto fov_ver = (ver_left + ver_right) / 2.0;
+    const auto ver_right = right.deg_top - right.deg_bottom;
+    const auto ver_left = left.deg_top - left.deg_bottom;
+    res.fov_ver = (ver_left + ver_right) / 2.0;
 
     // diagonal FOV is calculated from diagonal FOV points:
     // [left_eye:left_bottom] <-> [right_eye:right_top]
     // and the other diagonal and is averaged over the two
-    const hvector_t left_bottom = fov_head[j_leye][j_fov_pts][0];
-    const hvector_t left_top = fov_head[j_leye][j_fov_pts][6];
-    const hvector_t right_top = fov_head[j_reye][j_fov_pts][4];
-    const hvector_t right_bottom = fov_head[j_reye][j_fov_pts][2];
+    const hvector_t left_bottom = xt::view(left.fov_pts, 0);
+    const hvector_t left_top = xt::view(left.fov_pts, 6);
+    const hvector_t right_top = xt::view(right.fov_pts, 4);
+    const hvector_t right_bottom = xt::view(right.fov_pts, 2);
     const auto diag1 = angle_deg(left_bottom, right_top);
     const auto diag2 = angle_deg(left_top, right_bottom);
-    const auto fov_diag = (diag1 + diag2) / 2;
+    res.fov_diag = (diag1 + diag2) / 2;
 
     // overlap
-    const auto overlap = fov_head[j_leye][j_deg_right].get<double>()
-        - fov_head[j_reye][j_deg_left].get<double>();
+    res.overlap = left.deg_right - right.deg_left;
+
+    return res;
+}
 
-    return json({{j_fov_hor, fov_hor},
-                 {j_fov_ver, fov_ver},
-                 {j_fov_diag, fov_diag},
-                 {j_overlap, overlap}});
+//  Calculate total FOVs from the head FOVs stored in JSON.
+json calc_total_fov(const json& fov_head)
+{
+    const std::array<EyeFov, EYES> fovs
+        = {parse_eye_fov(fov_head[j_leye]), parse_eye_fov(fov_head[j_reye])};
+    return total_fov_to_json(calc_total_fov(fovs));
 }
 
 //  Calculate the angle of the canted views and the IPD from eye to head transformation
 //  matrices.
-json calc_view_geom(const json& e2h)
+ViewGeom calc_view_geom(const harray2d_t& left, const harray2d_t& right)
 {
-    const harray2d_t left = e2h[j_leye];
-    const harray2d_t right = e2h[j_reye];
     const auto cols = left.shape(1);
 
     // angle = acos(t dot v)/(|t|*|v|), where t = e2h * v
     // for v = [0, 0, -1] in eye coordinates => angle = acos(e2h[2,2])
     // direction e2h[0,2] > 0 => anti-clockwise, e2h[0,2] < 0 => clockwise
     // for simplicity use e2h[i, j] = e2h(i * cols + j)
-    const auto left_rot
+    ViewGeom res;
+    res.left_rot
         = degrees(acos(left(2 * cols + 2)) * ((left(0 * cols + 2) > 0) ? -1.0 : 1.0));
-    const auto right_rot
+    res.right_rot
         = degrees(acos(right(2 * cols + 2)) * ((right(0 * cols + 2) > 0) ? -1.0 : 1.0));
     // IPD is stored in meters
-    const auto ipd = point_dist(xt::view(left, xt::all(), static_cast<size_t>(3)),
-                                xt::view(right, xt::all(), static_cast<size_t>(3)));
-    return json({{j_left_rot, left_rot}, {j_right_rot, right_rot}, {j_ipd, ipd}});
+    res.ipd = point_dist(xt::view(left, xt::all(), static_cast<size_t>(3)),
+                         xt::view(right, xt::all(), static_cast<size_t>(3)));
+    return res;
 }
 
-//  Calculate the additional data in the geometry data object (json)
-json calc_geometry(const json& jd)
+//  Calculate the additional data of one eye (touches only the eye's own data, so both
+//  eyes can be calculated in parallel).
+static void calc_eye_geometry(Geometry& geom, size_t i, size_t profile)
 {
-    json fov_eye;
-    json fov_head;
-    json ham_mesh;
+    // get eye to head transformation matrix
+    const auto& e2h = geom.eye2head[i];
 
-    if (jd.contains(j_ham_mesh)) {
-        ham_mesh = jd[j_ham_mesh];
-    } else {
-        ham_mesh = json::object({{j_leye, json()}, {j_reye, json()}});
+    // calculate optimized HAM mesh values
+    if (geom.ham_mesh[i]) {
+        calc_opt_ham_mesh(*geom.ham_mesh[i]);
+        geom.ham_mesh[i]->ham_area = calc_ham_area(*geom.ham_mesh[i]);
     }
 
-    for (const auto& neye : {j_leye, j_reye}) {
-
-        // get eye to head transformation matrix
-        const auto e2h = jd[j_eye2head][neye].get<harray2d_t>();
-
-        // get raw eye values (direct from OpenVR)
-        const auto raw_eye = jd[j_raw_eye][neye];
-
-        // calculate optimized HAM mesh values
-        if (!ham_mesh[neye].is_null()) {
-            ham_mesh[neye] = calc_opt_ham_mesh(ham_mesh[neye]);
-            ham_mesh[neye][j_ham_area] = calc_ham_area(ham_mesh[neye]);
-        }
-
-        // build eye FOV points only if the eye FOV is rotated
-        if (xt::view(e2h, xt::all(), xt::range(0, 3)) != xt::eye<double>(3, 0)) {
-            fov_eye[neye] = calc_fov(raw_eye, ham_mesh[neye]);
-        }
+    // lift the HAM into the frustum once for both eye and head FOV points
+    const auto fmesh = calc_frustum_mesh(geom.raw_eye[i],
+                                         geom.ham_mesh[i] ? &*geom.ham_mesh[i] : nullptr);
 
-        // build head FOV points (they are eye FOV points if the views are parallel)
-        harray2d_t rot = xt::view(e2h, xt::all(), xt::range(0, 3));
-        fov_head[neye] = calc_fov(raw_eye, ham_mesh[neye], &rot);
+    // build eye FOV points only if the eye FOV is rotated
+    if (xt::view(e2h, xt::all(), xt::range(0, 3)) != xt::eye<double>(3, 0)) {
+        geom.fov_eye[i] = calc_fov(fmesh, nullptr, profile);
+    } else {
+        geom.fov_eye[i].reset();
     }
 
+    // build head FOV points (they are eye FOV points if the views are parallel)
+    harray2d_t rot = xt::view(e2h, xt::all(), xt::range(0, 3));
+    geom.fov_head[i] = calc_fov(fmesh, &rot, profile);
+}
+
+//  Calculate the additional data which depend on both eyes.
+static void calc_head_geometry(Geometry& geom)
+{
     // calculate total FOVs and the overlap
-    auto fov_tot = calc_total_fov(fov_head);
+    geom.fov_tot = calc_total_fov(geom.fov_head);
 
     // calculate view rotation and the IPD
-    auto view_geom = calc_view_geom(jd[j_eye2head]);
+    geom.view_geom = calc_view_geom(geom.eye2head[LEYE], geom.eye2head[REYE]);
+}
 
-    // create a new object to ensure the right order of the newly inserted objects
-    json res;
-    // copy first only certain properties and only if they exist.
-    // At the moment, it only concerns Oculus specific j_render_desc.
-    for (const auto& name : {j_rec_rts, j_raw_eye, j_eye2head, j_render_desc}) {
-        if (jd.contains(name)) {
-            res[name] = jd[name];
-        }
+//  Calculate the additional data in the geometry
+void calc_geometry(Geometry& geom, size_t profile)
+{
+    for (size_t i = 0; i < EYES; ++i) {
+        calc_eye_geometry(geom, i, profile);
     }
-    res[j_view_geom] = view_geom;
-    res[j_fov_eye] = fov_eye;
-    res[j_fov_head] = fov_head;
-    res[j_fov_tot] = fov_tot;
-    res[j_ham_mesh] = ham_mesh;
+    calc_head_geometry(geom);
+}
 
-    return res;
+//  Calculate the additional data in the geometry (the eyes as separate tasks)
+void calc_geometry(Geometry& geom, ThreadPool& pool, size_t profile)
+{
+    std::vector<std::future<void>> eyes;
+    for (size_t i = 0; i < EYES; ++i) {
+        eyes.push_back(
+            pool.submit([&geom, i, profile]() { calc_eye_geometry(geom, i, profile); }));
+    }
+    pool.wait_all(eyes);
+    calc_head_geometry(geom);
+}
+
+//  Calculate the additional data in the geometry data object (json)
+json calc_geometry(const json& jd, size_t profile)
+{
+    auto geom = parse_geometry(jd);
+    calc_geometry(geom, profile);
+    return geometry_to_json(geom, jd);
+}
+
+//  Calculate the additional data in the geometry data object (the eyes as separate
+//  tasks)
+json calc_geometry(const json& jd, ThreadPool& pool, size_t profile)
+{
+    auto geom = parse_geometry(jd);
+    calc_geometry(geom, pool, profile);
+    return geometry_to_json(geom, jd);
 }
 
 //  Check to catch invalid raw frustum in (Quest 2 - firmware major 10579)
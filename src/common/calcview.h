@@ -11,32 +11,94 @@
 
 #pragma once
 
+#include <common/geom.h>
+#include <common/geomdef.h>
 #include <common/json_proxy.h>
 #include <common/xtdef.h>
 
+namespace geom {
+class FrustumMesh;
+}
+class ThreadPool;
+
 //  functions
 //------------------------------------------------------------------------------
 //  load or build verts and faces from recorded data
-std::tuple<harray2d_t, hfaces_t, bool> calc_resolve_verts_and_faces(const json& ham_mesh);
+std::tuple<harray2d_t, hcfaces_t, bool> calc_resolve_verts_and_faces(
+    const json& ham_mesh);
+
+//  Parse raw eye frustum from JSON
+RawEye parse_raw_eye(const json& raw);
+
+//  Parse HAM mesh from JSON (only the recorded data and the area are loaded)
+HamMesh parse_ham_mesh(const json& ham_mesh);
+
+//  Parse eye FOV from JSON
+EyeFov parse_eye_fov(const json& fov);
+
+//  Parse geometry input data (raw eyes, eye to head transformations and HAM meshes)
+//  from JSON
+Geometry parse_geometry(const json& jd);
+
+//  Serialize HAM mesh into JSON
+json ham_mesh_to_json(const HamMesh& mesh);
+
+//  Serialize eye FOV into JSON
+json eye_fov_to_json(const EyeFov& fov);
+
+//  Serialize total FOV into JSON
+json total_fov_to_json(const TotalFov& fov);
+
+//  Serialize the geometry into JSON, `jd` is the original geometry object from which
+//  the properties not covered by `Geometry` are copied.
+json geometry_to_json(const Geometry& geom, const json& jd);
+
+//  Calculate optimized HAM mesh topology
+void calc_opt_ham_mesh(HamMesh& mesh);
 
 //  Calculate optimized HAM mesh topology
 json calc_opt_ham_mesh(const json& ham_mesh);
 
-//  Calculate HAM area
-double calc_ham_area(const json& ham_mesh);
+//  Calculate HAM area (optionally collecting the clipper statistics in `stats`).
+double calc_ham_area(const HamMesh& mesh, ClipStats* stats = nullptr);
+
+//  Calculate HAM area (optionally collecting the clipper statistics in `stats`).
+double calc_ham_area(const json& ham_mesh, ClipStats* stats = nullptr);
+
+//  Prepare the frustum mesh (HAM lifted into the frustum) to be shared by multiple
+//  FOV calculations of the same eye.
+geom::FrustumMesh calc_frustum_mesh(const RawEye& raw, const HamMesh* mesh = nullptr);
 
-//  Calculate partial FOVs for the projection (new version).
-json calc_fov(const json& raw, const json& mesh, const harray2d_t* rot = nullptr);
+//  Calculate partial FOVs for the projection from the prepared frustum mesh. If
+//  `profile` is non-zero, add also the FOV profile sampled at `profile` polar angles.
+EyeFov calc_fov(const geom::FrustumMesh& fmesh, const harray2d_t* rot = nullptr,
+                size_t profile = 0);
 
 //  Calculate total FOV, vertical, horizontal and diagonal.
+TotalFov calc_total_fov(const std::array<EyeFov, EYES>& fov_head);
+
+//  Calculate total FOV, vertical, horizontal and diagonal from JSON data.
 json calc_total_fov(const json& fov_head);
 
 //  Calculate the angle of the canted views and the IPD from eye to head transformation
 //  matrices.
-json calc_view_geom(const json& e2h);
+ViewGeom calc_view_geom(const harray2d_t& left, const harray2d_t& right);
+
+//  Calculate the additional data in the geometry, optionally with the FOV profiles
+//  sampled at `profile` polar angles.
+void calc_geometry(Geometry& geom, size_t profile = 0);
+
+//  Calculate the additional data in the geometry data object (json), optionally with
+//  the FOV profiles sampled at `profile` polar angles.
+json calc_geometry(const json& jd, size_t profile = 0);
+
+//  Calculate the additional data in the geometry, the eyes are calculated as separate
+//  tasks in the pool.
+void calc_geometry(Geometry& geom, ThreadPool& pool, size_t profile = 0);
 
-//  Calculate the additional data in the geometry data object (json)
-json calc_geometry(const json& jd);
+//  Calculate the additional data in the geometry data object (json), the eyes are
+//  calculated as separate tasks in the pool.
+json calc_geometry(const json& jd, ThreadPool& pool, size_t profile = 0);
 
 //  Do sanity check on geometry data (Quest 2 - firmware major 10579)
 //  Augment the JSON data with the error code if one is found.
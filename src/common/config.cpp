@@ -26,6 +26,9 @@
 //------------------------------------------------------------------------------
 json g_cfg;
 
+static ConfigSnapshot s_cfgs;
+const ConfigSnapshot& g_cfgs = s_cfgs;
+
 //  config versions
 //------------------------------------------------------------------------------
 //  v1: Original file format defined by the tool.
@@ -139,6 +142,43 @@ static std::filesystem::path build_conf_name(const std::filesystem::path& argv0)
     return conf_name.replace_extension(CONF_EXT);
 }
 
+//  Build VR subsystem config snapshot from its section `jd` (if present).
+static SubsysConfig build_subsys_snapshot(const json& jd)
+{
+    SubsysConfig res;
+    if (jd.is_object()) {
+        if (jd.contains(j_verbosity)) {
+            for (const auto& [pname, pverb] : jd[j_verbosity][j_properties].items()) {
+                res.verb_props[pname] = pverb.get<int>();
+            }
+        }
+        if (jd.contains(j_anonymize)) {
+            for (const auto& pname : jd[j_anonymize][j_properties]) {
+                res.anon_props.insert(pname.get<std::string>());
+            }
+        }
+    }
+    return res;
+}
+
+//  Build config snapshot from (loaded) config `jd`.
+static ConfigSnapshot build_snapshot(const json& jd)
+{
+    ConfigSnapshot res;
+    res.anonymize = jd[j_control][j_anonymize].get<bool>();
+    res.json_indent = jd[j_format][j_json_indent].get<int>();
+    res.cli_indent = jd[j_format][j_cli_indent].get<int>();
+    const auto& jverb = jd[j_verbosity];
+    res.verb.silent = jverb[j_silent].get<int>();
+    res.verb.def = jverb[j_default].get<int>();
+    res.verb.geom = jverb[j_geometry].get<int>();
+    res.verb.max = jverb[j_max].get<int>();
+    res.verb.error = jverb[j_error].get<int>();
+    res.openvr = build_subsys_snapshot(jd.value(j_openvr, json()));
+    res.oculus = build_subsys_snapshot(jd.value(j_oculus, json()));
+    return res;
+}
+
 //  exported functions
 //------------------------------------------------------------------------------
 //  Initialize config options either from the file or from the defaults.
@@ -162,5 +202,6 @@ bool init_config(const std::filesystem::path& argv0, const cfgmap_t& cfgs)
             return false;
         }
     }
+    s_cfgs = build_snapshot(g_cfg);
     return true;
 }
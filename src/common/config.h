@@ -15,12 +15,45 @@
 #include <common/json_proxy.h>
 
 #include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+//  typedefs
+//------------------------------------------------------------------------------
+//  Verbosity levels
+struct VerbLevels {
+    int silent = 0;
+    int def = 0;
+    int geom = 0;
+    int max = 0;
+    int error = 0;
+};
+
+//  VR subsystem config (OpenVR, Oculus)
+struct SubsysConfig {
+    std::unordered_map<std::string, int> verb_props; // properties verbosity levels
+    std::unordered_set<std::string> anon_props; // properties to anonymize
+};
+
+//  Typed snapshot of the config (resolved once by `init_config`)
+struct ConfigSnapshot {
+    bool anonymize = false;
+    int json_indent = 0;
+    int cli_indent = 0;
+    VerbLevels verb;
+    SubsysConfig openvr;
+    SubsysConfig oculus;
+};
+
 //  globals
 //------------------------------------------------------------------------------
 extern json g_cfg;
 
+//  Config snapshot, immutable after `init_config` (use instead of `g_cfg` lookups)
+extern const ConfigSnapshot& g_cfgs;
+
 //  functions
 //------------------------------------------------------------------------------
 //  Initialize config options either from the file or from the defaults.
@@ -14,15 +14,102 @@
 #include <fmt/format.h>
 
 #include <cstdio>
+#include <iterator>
+#include <string>
 #include <utility>
 
+//  Output sink which collects the printed text in a memory buffer and writes it into
+//  the target (a file, or a string) in large chunks. While the sink exists, `iprint`
+//  and `oprint` called from the same thread write into it instead of stdout.
+class OutSink
+{
+  public:
+    explicit OutSink(std::FILE* f)
+        : m_file(f)
+    {
+        activate();
+    }
+    explicit OutSink(std::string& str)
+        : m_str(&str)
+    {
+        activate();
+    }
+    OutSink(const OutSink&) = delete;
+    OutSink& operator=(const OutSink&) = delete;
+    ~OutSink()
+    {
+        flush();
+        s_current = m_prev;
+    }
+
+  public:
+    //  Return the active sink of the current thread (or nullptr if there is none).
+    static OutSink* current()
+    {
+        return s_current;
+    }
+
+    template <typename... T>
+    void print(fmt::format_string<T...> format_str, T&&... args)
+    {
+        fmt::format_to(std::back_inserter(m_buffer), format_str,
+                       std::forward<T>(args)...);
+        if (m_buffer.size() >= FLUSH_SIZE) {
+            flush();
+        }
+    }
+
+    //  Write the buffered text into the target.
+    void flush()
+    {
+        if (m_buffer.size() == 0) {
+            return;
+        }
+        const auto text = fmt::string_view(m_buffer.data(), m_buffer.size());
+        if (m_file) {
+            // let fmt handle the (Unicode) console output
+            fmt::print(m_file, "{}", text);
+        } else {
+            m_str->append(text.data(), text.size());
+        }
+        m_buffer.clear();
+    }
+
+  private:
+    void activate()
+    {
+        m_prev = s_current;
+        s_current = this;
+    }
+
+  private:
+    static constexpr size_t FLUSH_SIZE = 64 * 1024;
+    static inline thread_local OutSink* s_current = nullptr;
+
+    fmt::memory_buffer m_buffer;
+    std::FILE* m_file = nullptr;
+    std::string* m_str = nullptr;
+    OutSink* m_prev = nullptr;
+};
+
+//  Print into the active output sink (or to stdout if there is none).
+template <typename... T>
+void oprint(fmt::format_string<T...> format_str, T&&... args)
+{
+    if (auto out = OutSink::current()) {
+        out->print(format_str, std::forward<T>(args)...);
+    } else {
+        fmt::print(format_str, std::forward<T>(args)...);
+    }
+}
+
 //  These functions are attributed to vitaut@github as per this discussion
 //  https://github.com/fmtlib/fmt/issues/1260
 template <typename... T>
 void iprint(int indent, fmt::format_string<T...> format_str, T&&... args)
 {
-    fmt::print("{:{}}", "", indent);
-    fmt::print(format_str, std::forward<T>(args)...);
+    oprint("{:{}}", "", indent);
+    oprint(format_str, std::forward<T>(args)...);
 }
 
 template <typename... T>
@@ -17,6 +17,90 @@
 #include <geos/geom/Geometry.h>
 #include <geos/geom/GeometryFactory.h>
 
+#include <algorithm>
+#include <array>
+
+//  locals
+//------------------------------------------------------------------------------
+//  A convex polygon clipped by 4 sides of a rectangle has at most 3 + 4 vertices.
+static constexpr size_t CLIP_MAX_VERTS = 8;
+
+//  2D point for the polygon clipper
+struct ClipPoint {
+    double x;
+    double y;
+};
+
+//  Polygon buffer for the polygon clipper
+struct ClipPoly {
+    std::array<ClipPoint, CLIP_MAX_VERTS> pts;
+    size_t size = 0;
+};
+
+//  Clip the convex polygon `in` by one side of the axis aligned rectangle and store
+//  the result in `out` (Sutherland-Hodgman). `Axis` selects the coordinate (0: x,
+//  1: y), `Upper` selects whether the inside is below (true) or above the `limit`.
+template <int Axis, bool Upper>
+static void clip_side(const ClipPoly& in, ClipPoly& out, double limit)
+{
+    const auto coord = [](const ClipPoint& p) { return Axis == 0 ? p.x : p.y; };
+    const auto inside = [&](const ClipPoint& p) {
+        return Upper ? coord(p) <= limit : coord(p) >= limit;
+    };
+    // intersection of the edge (p1, p2) with the clipping line, interpolated from the
+    // end point closer to the line to limit the round-off error
+    const auto isect = [&](const ClipPoint& p1, const ClipPoint& p2) {
+        const bool swap = std::abs(limit - coord(p1)) > std::abs(limit - coord(p2));
+        const ClipPoint& a = swap ? p2 : p1;
+        const ClipPoint& b = swap ? p1 : p2;
+        const double t = (limit - coord(a)) / (coord(b) - coord(a));
+        if (Axis == 0) {
+            return ClipPoint{limit, a.y + t * (b.y - a.y)};
+        } else {
+            return ClipPoint{a.x + t * (b.x - a.x), limit};
+        }
+    };
+
+    out.size = 0;
+    if (in.size == 0) {
+        return;
+    }
+    const ClipPoint* prev = &in.pts[in.size - 1];
+    bool prev_in = inside(*prev);
+    for (size_t i = 0; i < in.size; ++i) {
+        const ClipPoint& curr = in.pts[i];
+        const bool curr_in = inside(curr);
+        if (curr_in) {
+            if (!prev_in) {
+                out.pts[out.size++] = isect(*prev, curr);
+            }
+            out.pts[out.size++] = curr;
+        } else if (prev_in) {
+            out.pts[out.size++] = isect(*prev, curr);
+        }
+        prev = &curr;
+        prev_in = curr_in;
+    }
+}
+
+//  Calculate the (unsigned) area of the polygon (shoelace formula relative to the
+//  first vertex).
+static double area_poly(const ClipPoly& poly)
+{
+    if (poly.size < 3) {
+        return 0.0;
+    }
+    const double x0 = poly.pts[0].x;
+    double sum = 0.0;
+    for (size_t i = 1; i < poly.size; ++i) {
+        const double x = poly.pts[i].x - x0;
+        const double y1 = poly.pts[(i + 1) % poly.size].y;
+        const double y2 = poly.pts[i - 1].y;
+        sum += x * (y2 - y1);
+    }
+    return std::abs(sum / 2.0);
+}
+
 //  functions
 //------------------------------------------------------------------------------
 //  Calculate the area of the triangle given by the vertices.
@@ -29,10 +113,11 @@ double area_triangle(const hvector_t& v1, const hvector_t& v2, const hvector_t&
 
 //  Calculate the mesh area from given triangles. Triangle are specified by vertices
 //  indexed by an index array.
-double area_mesh_tris_idx(const harray2d_t& verts, const hfaces_t& tris)
+double area_mesh_tris_idx(const harray2d_t& verts, const hcfaces_t& tris)
 {
     double a = 0;
-    for (const auto& face : tris) {
+    for (size_t i = 0, e = tris.size(); i < e; ++i) {
+        const auto face = tris[i];
         HMDQ_ASSERT(face.size() == 3);
         a += area_triangle(xt::view(verts, face[0]), xt::view(verts, face[1]),
                            xt::view(verts, face[2]));
@@ -40,7 +125,70 @@ double area_mesh_tris_idx(const harray2d_t& verts, const hfaces_t& tris)
     return a;
 }
 
-double area_mesh_tris_idx_geos(const harray2d_t& verts, const hfaces_t& tris)
+//  Calculate the area of the triangle (given by 2D vertices) clipped by the
+//  (0,0)-(1,1) rectangle.
+double area_triangle_clip(const std::array<double, 2>& v1,
+                          const std::array<double, 2>& v2,
+                          const std::array<double, 2>& v3)
+{
+    ClipPoly poly;
+    ClipPoly temp;
+    poly.pts[0] = {v1[0], v1[1]};
+    poly.pts[1] = {v2[0], v2[1]};
+    poly.pts[2] = {v3[0], v3[1]};
+    poly.size = 3;
+    clip_side<0, false>(poly, temp, 0.0);
+    clip_side<0, true>(temp, poly, 1.0);
+    clip_side<1, false>(poly, temp, 0.0);
+    clip_side<1, true>(temp, poly, 1.0);
+    return area_poly(poly);
+}
+
+//  Calculate the mesh area from given triangles clipped by the (0,0)-(1,1) rectangle.
+//  Triangle are specified by vertices indexed by an index array (native clipper).
+//  Triangles are classified by their bounding boxes first, only those crossing the
+//  rectangle border are clipped.
+double area_mesh_tris_idx_clip(const harray2d_t& verts, const hcfaces_t& tris,
+                               ClipStats* stats)
+{
+    ClipStats cnt;
+    double a = 0.0;
+    for (size_t i = 0, e = tris.size(); i < e; ++i) {
+        const auto face = tris[i];
+        HMDQ_ASSERT(face.size() == 3);
+        const double x1 = verts(face[0], 0);
+        const double y1 = verts(face[0], 1);
+        const double x2 = verts(face[1], 0);
+        const double y2 = verts(face[1], 1);
+        const double x3 = verts(face[2], 0);
+        const double y3 = verts(face[2], 1);
+        const double xmin = std::min({x1, x2, x3});
+        const double xmax = std::max({x1, x2, x3});
+        const double ymin = std::min({y1, y2, y3});
+        const double ymax = std::max({y1, y2, y3});
+        if (xmin >= 0.0 && xmax <= 1.0 && ymin >= 0.0 && ymax <= 1.0) {
+            // same formula as `area_poly` gives for an unclipped triangle
+            a += std::abs(((x2 - x1) * (y1 - y3) + (x3 - x1) * (y2 - y1)) / 2.0);
+            ++cnt.inside;
+        } else if (xmax <= 0.0 || xmin >= 1.0 || ymax <= 0.0 || ymin >= 1.0) {
+            ++cnt.outside;
+        } else {
+            // straddling the border (or having NaN coordinates)
+            a += area_triangle_clip({x1, y1}, {x2, y2}, {x3, y3});
+            ++cnt.clipped;
+        }
+    }
+    if (stats) {
+        stats->inside += cnt.inside;
+        stats->outside += cnt.outside;
+        stats->clipped += cnt.clipped;
+    }
+    return a;
+}
+
+//  Calculate the mesh area from given triangles. Triangle are specified by vertices
+//  indexed by an index array (using GEOS library)
+double area_mesh_tris_idx_geos(const harray2d_t& verts, const hcfaces_t& tris)
 {
     using namespace geos::geom;
 
@@ -49,7 +197,8 @@ double area_mesh_tris_idx_geos(const harray2d_t& verts, const hfaces_t& tris)
         CoordinateSequence({CoordinateXY{0, 0}, CoordinateXY{0, 1}, CoordinateXY{1, 1},
                             CoordinateXY{1, 0}, CoordinateXY{0, 0}}))};
     double a = 0.0;
-    for (const auto& face : tris) {
+    for (size_t i = 0, e = tris.size(); i < e; ++i) {
+        const auto face = tris[i];
         HMDQ_ASSERT(face.size() == 3);
         auto t_coords{CoordinateSequence(
             {CoordinateXY{xt::view(verts, face[0])[0], xt::view(verts, face[0])[1]},
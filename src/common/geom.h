@@ -13,8 +13,24 @@
 
 #include <common/xtdef.h>
 
+#include <array>
 #include <cmath>
 
+//  globals
+//------------------------------------------------------------------------------
+//  Relative tolerance between the HAM areas calculated by the native clipper and by
+//  GEOS (used before v2.2.0), the two algorithms round off differently
+constexpr double HAM_AREA_ALGO_TOLERANCE = 1e-12;
+
+//  types
+//------------------------------------------------------------------------------
+//  Triangle classification counters collected by the mesh clipper
+struct ClipStats {
+    size_t inside = 0; // triangles fully inside the clipping rectangle
+    size_t outside = 0; // triangles fully outside the clipping rectangle
+    size_t clipped = 0; // triangles crossing the rectangle border
+};
+
 //  functions
 //------------------------------------------------------------------------------
 //  Compute degrees out of radians.
@@ -67,8 +83,40 @@ double area_triangle(const hvector_t& v1, const hvector_t& v2, const hvector_t&
 
 //  Calculate the mesh area from given triangles. Triangle are specified by vertices
 //  indexed by an index array.
-double area_mesh_tris_idx(const harray2d_t& verts, const hfaces_t& tris);
+double area_mesh_tris_idx(const harray2d_t& verts, const hcfaces_t& tris);
+
+//  Calculate the mesh area from given triangles (legacy face list).
+inline double area_mesh_tris_idx(const harray2d_t& verts, const hfaces_t& tris)
+{
+    return area_mesh_tris_idx(verts, to_cfaces(tris));
+}
+
+//  Calculate the area of the triangle (given by 2D vertices) clipped by the
+//  (0,0)-(1,1) rectangle.
+double area_triangle_clip(const std::array<double, 2>& v1,
+                          const std::array<double, 2>& v2,
+                          const std::array<double, 2>& v3);
+
+//  Calculate the mesh area from given triangles clipped by the (0,0)-(1,1) rectangle.
+//  Triangle are specified by vertices indexed by an index array (native clipper).
+//  If `stats` is given, the triangle classification counts are added to it.
+double area_mesh_tris_idx_clip(const harray2d_t& verts, const hcfaces_t& tris,
+                               ClipStats* stats = nullptr);
+
+//  Calculate the mesh area from given triangles clipped by the (0,0)-(1,1) rectangle
+//  (legacy face list).
+inline double area_mesh_tris_idx_clip(const harray2d_t& verts, const hfaces_t& tris,
+                                      ClipStats* stats = nullptr)
+{
+    return area_mesh_tris_idx_clip(verts, to_cfaces(tris), stats);
+}
 
 //  Calculate the mesh area from given triangles. Triangle are specified by vertices
 //  indexed by an index array (using GEOS library)
-double area_mesh_tris_idx_geos(const harray2d_t& verts, const hfaces_t& tris);
+double area_mesh_tris_idx_geos(const harray2d_t& verts, const hcfaces_t& tris);
+
+//  Calculate the mesh area from given triangles using GEOS library (legacy face list).
+inline double area_mesh_tris_idx_geos(const harray2d_t& verts, const hfaces_t& tris)
+{
+    return area_mesh_tris_idx_geos(verts, to_cfaces(tris));
+}
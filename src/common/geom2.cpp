@@ -11,19 +11,25 @@
 
 #include <common/geom2.h>
 
-#include <xtensor/xadapt.hpp>
 #include <xtensor/xindex_view.hpp>
 #include <xtensor/xview.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+
 namespace geom {
 
 //  helper functions
 //------------------------------------------------------------------------------
 //  Convert faces to edges
-hedgelist_t faces_to_edges(const hfaces_t& faces)
+hedgelist_t faces_to_edges(const hcfaces_t& faces)
 {
     hedgelist_t edges;
-    for (const auto& f : faces) {
+    // each face has as many edges as vertices
+    edges.reserve(faces.indices.size());
+    for (size_t fi = 0, fe = faces.size(); fi < fe; ++fi) {
+        const auto f = faces[fi];
         size_t e = f.size();
         for (size_t i = 0; i < e; ++i) {
             edges.emplace_back<hedge_t>({f[i], f[(i + 1) % e]});
@@ -43,72 +49,169 @@ int polarity(const Plane& plane, const Point3& point)
     }
 }
 
+//  struct EdgeLines
+//------------------------------------------------------------------------------
+//  Build the lines from the mesh vertices and edges
+void EdgeLines::build(const harray2d_t& verts, const hedgelist_t& edges)
+{
+    const size_t count = edges.size();
+    for (auto* v : {&ox, &oy, &oz, &dx, &dy, &dz, &limit}) {
+        v->clear();
+        v->reserve(count);
+    }
+    for (const auto& edge : edges) {
+        const Point3 pt1(verts(edge.first, 0), verts(edge.first, 1),
+                         verts(edge.first, 2));
+        const Point3 pt2(verts(edge.second, 0), verts(edge.second, 1),
+                         verts(edge.second, 2));
+        // use Eigen to get the same (bitwise) line parameters as `Line::Through`
+        const Line line = Line::Through(pt1, pt2);
+        ox.push_back(line.origin().x());
+        oy.push_back(line.origin().y());
+        oz.push_back(line.origin().z());
+        dx.push_back(line.direction().x());
+        dy.push_back(line.direction().y());
+        dz.push_back(line.direction().z());
+        limit.push_back((pt2 - pt1).norm());
+    }
+}
+
+//  Zero the round-off noise in the FOV points and optionally project them onto the
+//  z=+/-1.0 plane.
+static harray2d_t finish_fov_points(harray2d_t& points, bool projected)
+{
+    //  sanitization
+    xt::filter(points, abs(points) < DOUBLE_EPS_100) = 0.0;
+    if (projected) {
+        // get the last column and use it to normalize the points
+        const auto tcol = xt::view(points, xt::all(), static_cast<size_t>(2));
+        const auto zcol = xt::expand_dims(tcol, 1);
+        // project the points onto z=+/-1.0 plane (again) to get "normalized" frustum
+        // points
+        harray2d_t tpoints = points / abs(zcol);
+        return tpoints;
+    } else {
+        return points;
+    }
+}
+
+//  Rotate the first `vcount` 3D vertices
+static harray2d_t rotate_verts(const harray2d_t& verts, size_t vcount,
+                               const Rotation& rot)
+{
+    using RowMatrix3 = Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>;
+    harray2d_t::shape_type shape = {vcount, 3};
+    harray2d_t res(shape);
+    const auto verts_e = Eigen::Map<const RowMatrix3>(verts.data(), vcount, 3);
+    auto res_e = Eigen::Map<RowMatrix3>(res.data(), vcount, 3);
+    res_e = verts_e * rot.matrix().transpose();
+    return res;
+}
+
 //  class Meshd
 //------------------------------------------------------------------------------
 
+//  Reserve the space for `nverts` vertices (with `ndim` coordinates) and `nedges`
+//  edges in total, so the following additions do not reallocate.
+void Meshd::reserve(size_t nverts, size_t ndim, size_t nedges)
+{
+    if (nverts > m_verts.shape(0) || (0 == m_vcount && ndim != m_verts.shape(1))) {
+        HMDQ_ASSERT(0 == m_vcount || ndim == m_verts.shape(1));
+        harray2d_t::shape_type shape = {std::max(nverts, m_vcount), ndim};
+        harray2d_t verts(shape);
+        if (m_vcount > 0) {
+            xt::view(verts, xt::range(0, m_vcount), xt::all())
+                = xt::view(m_verts, xt::range(0, m_vcount), xt::all());
+        }
+        m_verts = std::move(verts);
+    }
+    m_edges.reserve(nedges);
+}
+
 //  Add another mesh to this to form one mesh
 void Meshd::add_mesh(const harray2d_t& verts, const hedgelist_t& edges)
 {
-    //  if the members are not initialized, just initialize them
-    if (0 == m_verts.shape(0)) {
-        m_verts = verts;
-        m_edges = edges;
-    } else {
-        auto vcount = m_verts.shape(0);
-        //  add the vertices at the end
-        m_verts = xt::concatenate(xt::xtuple(m_verts, verts));
-        for (const auto& e : edges) {
-            m_edges.emplace_back<hedge_t>({e.first + vcount, e.second + vcount});
-        }
+    const size_t vcount = m_vcount;
+    const size_t nverts = vcount + verts.shape(0);
+    //  grow the buffers geometrically, so the repeated additions are amortized, the
+    //  first addition only sets the dimension if it does not match the reserved one
+    const bool dim_mismatch = 0 == vcount && verts.shape(1) != m_verts.shape(1);
+    if (nverts > m_verts.shape(0) || dim_mismatch) {
+        reserve(std::max(nverts, 2 * m_verts.shape(0)), verts.shape(1),
+                std::max(m_edges.size() + edges.size(), 2 * m_edges.capacity()));
     }
+    HMDQ_ASSERT(verts.shape(1) == m_verts.shape(1));
+    //  add the vertices at the end
+    xt::view(m_verts, xt::range(vcount, nverts), xt::all()) = verts;
+    m_vcount = nverts;
+    add_edges(edges, vcount);
 }
 
-//  class Frustum
+//  Add edges with the vertex indices shifted by `offset`
+void Meshd::add_edges(const hedgelist_t& edges, size_t offset)
+{
+    for (const auto& e : edges) {
+        m_edges.emplace_back<hedge_t>({e.first + offset, e.second + offset});
+    }
+}
+
+//  class FrustumMesh
 //------------------------------------------------------------------------------
-//  Calculates the frustum FOV while incorporating the hidden area mesh (HAM) if present.
-Frustum::Frustum(double left, double right, double bottom, double top,
-                 const Rotation* pRot, const Meshd* pHam)
+FrustumMesh::FrustumMesh(double left, double right, double bottom, double top,
+                         const Meshd* pHam)
     : m_leftTan(left)
     , m_rightTan(right)
     , m_bottomTan(bottom)
     , m_topTan(top)
-    , m_center(0, 0, 0)
+{
+    if (nullptr != pHam) {
+        get_ham_3d(&pHam->get_verts(), pHam->vert_count(), &pHam->get_edges(), m_ham3d);
+    } else {
+        get_ham_3d(nullptr, 0, nullptr, m_ham3d);
+    }
+}
+
+FrustumMesh::FrustumMesh(double left, double right, double bottom, double top,
+                         const harray2d_t& ham_verts, const hedgelist_t& ham_edges)
+    : m_leftTan(left)
+    , m_rightTan(right)
+    , m_bottomTan(bottom)
+    , m_topTan(top)
+{
+    get_ham_3d(&ham_verts, ham_verts.shape(0), &ham_edges, m_ham3d);
+}
+
+//  class Frustum
+//------------------------------------------------------------------------------
+//  Calculates the frustum FOV while incorporating the hidden area mesh (HAM) if present.
+Frustum::Frustum(const FrustumMesh& mesh, const Rotation* pRot)
+    : m_center(0, 0, 0)
     , m_forward(0, 0, -1)
-    , m_leftBottom(left, bottom, -1)
+    , m_leftBottom(mesh.get_left(), mesh.get_bottom(), -1)
     , m_bottom(0, -1, -1)
-    , m_rightBottom(right, bottom, -1)
+    , m_rightBottom(mesh.get_right(), mesh.get_bottom(), -1)
     , m_right(1, 0, -1)
-    , m_rightTop(right, top, -1)
+    , m_rightTop(mesh.get_right(), mesh.get_top(), -1)
     , m_top(0, 1, -1)
-    , m_leftTop(left, top, -1)
+    , m_leftTop(mesh.get_left(), mesh.get_top(), -1)
     , m_left(-1, 0, -1)
-    , m_pRot(pRot)
 {
-    if (nullptr != m_pRot) {
-        m_leftBottom = *m_pRot * m_leftBottom;
-        m_rightBottom = *m_pRot * m_rightBottom;
-        m_rightTop = *m_pRot * m_rightTop;
-        m_leftTop = *m_pRot * m_leftTop;
+    const Meshd& ham3d = mesh.get_mesh();
+    if (nullptr != pRot) {
+        m_leftBottom = *pRot * m_leftBottom;
+        m_rightBottom = *pRot * m_rightBottom;
+        m_rightTop = *pRot * m_rightTop;
+        m_leftTop = *pRot * m_leftTop;
+        m_hamLines.build(rotate_verts(ham3d.get_verts(), ham3d.vert_count(), *pRot),
+                         ham3d.get_edges());
+    } else {
+        m_hamLines.build(ham3d.get_verts(), ham3d.get_edges());
     }
 
     m_outPoints = {m_leftBottom, m_bottom, m_rightBottom, m_right,
                    m_rightTop,   m_top,    m_leftTop,     m_left};
     m_polarityPlaneIndexes = {3, 3, 3, 1, 3, 3, 3, 1};
 
-    //  add default LRBT rectangle to the HAM to ensure the FOV points will be found
-    //  in case the HAM does not cover all LRBT rectangle edges.
-    harray2d_t lrbt_verts = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
-    hedgelist_t lrbt_edges = {{0, 1}, {1, 2}, {2, 3}, {3, 0}};
-    std::unique_ptr<Meshd> tHam2d;
-    if (nullptr == pHam) {
-        tHam2d = std::make_unique<Meshd>(lrbt_verts, lrbt_edges);
-    } else {
-        tHam2d = std::make_unique<Meshd>(*pHam);
-        tHam2d->add_mesh(lrbt_verts, lrbt_edges);
-    }
-
-    get_ham_3d(*tHam2d, m_ham3d);
-
     for (const auto& point : m_outPoints) {
         m_pointPlanes.push_back(get_point_plane(point));
     }
@@ -117,43 +220,149 @@ Frustum::Frustum(double left, double right, double bottom, double top,
 //  Calculate all FOV points and put them into one array (LB, B, RB, ..)
 harray2d_t Frustum::get_fov_points(bool projected)
 {
-    const size_t ptcount = m_outPoints.size();
+    const auto raw_points = get_raw_fov_points();
+    const size_t ptcount = raw_points.size();
     harray2d_t::shape_type shape = {ptcount, 3};
     harray2d_t points(shape);
     for (size_t i = 0; i < ptcount; ++i) {
-        auto pt = get_raw_fov_point(i);
+        const auto& pt = raw_points[i];
         points(i, 0) = pt.x();
         points(i, 1) = pt.y();
         points(i, 2) = pt.z();
     }
-    //  sanitization
-    xt::filter(points, abs(points) < DOUBLE_EPS_100) = 0.0;
-    if (projected) {
-        // get the last column and use it to normalize the points
-        const auto tcol = xt::view(points, xt::all(), static_cast<size_t>(2));
-        const auto zcol = xt::expand_dims(tcol, 1);
-        // project the points onto z=+/-1.0 plane (again) to get "normalized" frustum
-        // points
-        harray2d_t tpoints = points / abs(zcol);
-        return tpoints;
-    } else {
-        return points;
+    return finish_fov_points(points, projected);
+}
+
+//  Calculate the FOV profile, i.e. the FOV outline points at `count` polar angles
+//  (evenly spaced, counter-clockwise from the right direction) around the view axis.
+//  The point at each angle is the closest intersection of the HAM edges with the
+//  half-plane, which contains the view axis and goes in the given direction. The edges
+//  are sorted by the polar angle of their start and swept together with the sample
+//  angles, so each sample only checks the edges whose angular span covers it.
+harray2d_t Frustum::get_fov_profile(size_t count, bool projected) const
+{
+    HMDQ_ASSERT(count > 0);
+    constexpr double PI2 = 2 * xt::numeric_constants<double>::PI;
+    // angular margin to catch the samples lying exactly at the edge end points
+    constexpr double ANGLE_EPS = 1e-9;
+
+    // angular span of the edge (as seen from the view axis)
+    struct Span {
+        double start;
+        double end;
+        size_t line;
+    };
+
+    const auto& lines = m_hamLines;
+    std::vector<Span> spans;
+    spans.reserve(lines.size());
+    for (size_t i = 0, e = lines.size(); i < e; ++i) {
+        const double x1 = lines.ox[i];
+        const double y1 = lines.oy[i];
+        const double x2 = lines.ox[i] + lines.dx[i] * lines.limit[i];
+        const double y2 = lines.oy[i] + lines.dy[i] * lines.limit[i];
+        const double cross = x1 * y2 - x2 * y1;
+        // skip the edges collinear with the view axis, they are covered by their
+        // neighbours
+        if (abs(cross) <= DOUBLE_EPS_100) {
+            continue;
+        }
+        // go counter-clockwise from a1 to a2
+        double a1 = atan2(y1, x1);
+        double a2 = atan2(y2, x2);
+        if (cross < 0) {
+            std::swap(a1, a2);
+        }
+        double width = a2 - a1;
+        if (width < 0) {
+            width += PI2;
+        }
+        double start = a1 - ANGLE_EPS;
+        if (start < 0) {
+            start += PI2;
+        }
+        const double end = start + width + 2 * ANGLE_EPS;
+        spans.push_back({start, end, i});
+        // the span wrapping over 2*PI continues from zero
+        if (end >= PI2) {
+            spans.push_back({start - PI2, end - PI2, i});
+        }
+    }
+    std::sort(spans.begin(), spans.end(),
+              [](const Span& a, const Span& b) { return a.start < b.start; });
+
+    harray2d_t::shape_type shape = {count, 3};
+    harray2d_t points(shape);
+    std::vector<const Span*> active;
+    size_t next = 0;
+    for (size_t k = 0; k < count; ++k) {
+        const double theta = PI2 * static_cast<double>(k) / static_cast<double>(count);
+        while (next < spans.size() && spans[next].start <= theta) {
+            active.push_back(&spans[next++]);
+        }
+        std::erase_if(active, [theta](const Span* span) { return span->end < theta; });
+
+        // the cut plane contains the view axis and the direction (c, s, 0)
+        const double c = cos(theta);
+        const double s = sin(theta);
+        double dmin = DOUBLE_MAX;
+        Point3 point;
+        bool found = false;
+        for (const Span* span : active) {
+            const size_t i = span->line;
+            const double nd = -s * lines.dx[i] + c * lines.dy[i];
+            if (nd == 0.0) {
+                continue;
+            }
+            const double t = (s * lines.ox[i] - c * lines.oy[i]) / nd;
+            if (t >= -DOUBLE_EPS_100 && t <= lines.limit[i] + DOUBLE_EPS_100) {
+                const Point3 pt(lines.ox[i] + lines.dx[i] * t,
+                                lines.oy[i] + lines.dy[i] * t,
+                                lines.oz[i] + lines.dz[i] * t);
+                // only the half-plane in the sample direction counts
+                if (c * pt.x() + s * pt.y() > 0) {
+                    const double dist = (m_center - pt).norm();
+                    if (dist < dmin) {
+                        dmin = dist;
+                        point = pt;
+                        found = true;
+                    }
+                }
+            }
+        }
+        HMDQ_ASSERT(found);
+        points(k, 0) = point.x();
+        points(k, 1) = point.y();
+        points(k, 2) = point.z();
     }
+    return finish_fov_points(points, projected);
 }
 
-//  Build 3D representation of the HAM inside the frustum from 2D UV definition
-void Frustum::get_ham_3d(const Meshd& ham2d, Meshd& ham3d)
+//  Build 3D representation of the HAM (the first `hcount` vertices of `pVerts`, if
+//  any) and the LRBT rectangle border inside the frustum from 2D UV definition
+void FrustumMesh::get_ham_3d(const harray2d_t* pVerts, size_t hcount,
+                             const hedgelist_t* pEdges, Meshd& ham3d)
 {
-    const auto& edges2d = ham2d.get_edges();
-    const auto& verts2d = ham2d.get_verts();
-
-    // add ones into the third "dimension" of the 2D points to acknowledge the
-    // translation
-    const size_t vcount = verts2d.shape(0);
-    xt::xtensor<double, 2>::shape_type shape = {vcount, 1};
-    const harray2d_t tones = xt::ones<double>(shape);
-    // nverts end up being transposed, which is useful for the matmul later
-    harray2d_t verts2d_h = xt::hstack(xt::xtuple(verts2d, tones));
+    //  add default LRBT rectangle to the HAM to ensure the FOV points will be found
+    //  in case the HAM does not cover all LRBT rectangle edges.
+    static const harray2d_t lrbt_verts = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+    static const hedgelist_t lrbt_edges = {{0, 1}, {1, 2}, {2, 3}, {3, 0}};
+
+    const size_t vcount = hcount + lrbt_verts.shape(0);
+
+    // put the HAM vertices (read directly from the caller's buffer) and the LRBT
+    // vertices into one array and add ones into the third "dimension" of the 2D points
+    // to acknowledge the translation
+    harray2d_t::shape_type shape = {vcount, 3};
+    harray2d_t verts2d_h(shape);
+    if (hcount > 0) {
+        HMDQ_ASSERT(nullptr != pVerts && pVerts->shape(1) == 2);
+        xt::view(verts2d_h, xt::range(0, hcount), xt::range(0, 2))
+            = xt::view(*pVerts, xt::range(0, hcount), xt::all());
+    }
+    xt::view(verts2d_h, xt::range(hcount, vcount), xt::range(0, 2)) = lrbt_verts;
+    xt::view(verts2d_h, xt::all(), static_cast<size_t>(2)) = 1.0;
+
     auto verts2d_h_e
         = Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>>(
             verts2d_h.data(), vcount, 3);
@@ -164,49 +373,73 @@ void Frustum::get_ham_3d(const Meshd& ham2d, Meshd& ham3d)
     //  frustum projection plane is constructed.
     verts_trans.col(2).setConstant(-1.0);
 
-    if (nullptr != m_pRot) {
-        auto verts_rot = verts_trans * m_pRot->matrix().transpose();
-        verts_trans = verts_rot;
+    // reuse the homogeneous array for the 3D vertices
+    std::copy_n(verts_trans.data(), vcount * 3, verts2d_h.data());
+
+    const size_t hedges = (nullptr == pEdges) ? 0 : pEdges->size();
+    ham3d = Meshd(std::move(verts2d_h), hedgelist_t());
+    ham3d.reserve(vcount, 3, hedges + lrbt_edges.size());
+    if (nullptr != pEdges) {
+        ham3d.add_edges(*pEdges);
     }
-    shape = {vcount, 3};
-    harray2d_t verts3d_rot
-        = xt::adapt(verts_trans.data(), vcount * 3, xt::no_ownership(), shape);
-    ham3d.add_mesh(verts3d_rot, edges2d);
+    ham3d.add_edges(lrbt_edges, hcount);
 }
 
-//  Calculate one "raw" FOV point as an intersection of a "point-plane" and the HAM
-Point3 Frustum::get_raw_fov_point(size_t n)
+//  Calculate all "raw" FOV points as intersections of the "point-planes" and the HAM
+//  edges.
+Point3Array Frustum::get_raw_fov_points() const
 {
-    const Plane& polPlane = m_pointPlanes[m_polarityPlaneIndexes[n]];
-    const Plane& cutPlane = m_pointPlanes[n];
-    int outPointPol = polarity(polPlane, m_outPoints[n]);
-    double dmin = DOUBLE_MAX;
-    Point3 point;
-    bool found = false;
-    const harray2d_t& verts = m_ham3d.get_verts();
-    for (const auto& edge : m_ham3d.get_edges()) {
-        auto xpt1 = xt::view(verts, edge.first);
-        auto xpt2 = xt::view(verts, edge.second);
-        Point3 pt1 = Point3(xpt1(0), xpt1(1), xpt1(2));
-        Point3 pt2 = Point3(xpt2(0), xpt2(1), xpt2(2));
-        double limit = (pt2 - pt1).norm();
-        const Line line = Line::Through(pt1, pt2);
-        double t = line.intersectionParameter(cutPlane);
-        if (t >= -DOUBLE_EPS_100 && t <= limit + DOUBLE_EPS_100) {
-            Point3 pt = line.pointAt(t);
-            int ptPol = polarity(polPlane, pt);
-            if (ptPol == outPointPol) {
-                double dist = (m_center - pt).norm();
-                if (dist < dmin) {
-                    dmin = dist;
-                    point = pt;
-                    found = true;
+    HMDQ_ASSERT(m_pointPlanes.size() == FOV_POINTS);
+    std::array<const Plane*, FOV_POINTS> polPlanes;
+    std::array<int, FOV_POINTS> outPointPols;
+    for (size_t n = 0; n < FOV_POINTS; ++n) {
+        polPlanes[n] = &m_pointPlanes[m_polarityPlaneIndexes[n]];
+        outPointPols[n] = polarity(*polPlanes[n], m_outPoints[n]);
+    }
+
+    std::array<double, FOV_POINTS> dmin;
+    dmin.fill(DOUBLE_MAX);
+    std::array<bool, FOV_POINTS> found{};
+    Point3Array points(FOV_POINTS);
+
+    //  The planes go one by one over the line columns, first the intersection
+    //  parameters of all lines are calculated in a branchless (vectorizable) loop,
+    //  then the intersections within the edges are checked.
+    const auto& lines = m_hamLines;
+    const size_t count = lines.size();
+    std::vector<double> tpar(count);
+    for (size_t n = 0; n < FOV_POINTS; ++n) {
+        const auto& plane = m_pointPlanes[n];
+        const double nx = plane.normal().x();
+        const double ny = plane.normal().y();
+        const double nz = plane.normal().z();
+        const double offset = plane.offset();
+        for (size_t i = 0; i < count; ++i) {
+            const double dist = offset + nx * lines.ox[i] + ny * lines.oy[i]
+                + nz * lines.oz[i];
+            tpar[i] = -dist / (nx * lines.dx[i] + ny * lines.dy[i] + nz * lines.dz[i]);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            const double t = tpar[i];
+            if (t >= -DOUBLE_EPS_100 && t <= lines.limit[i] + DOUBLE_EPS_100) {
+                const Point3 pt(lines.ox[i] + t * lines.dx[i],
+                                lines.oy[i] + t * lines.dy[i],
+                                lines.oz[i] + t * lines.dz[i]);
+                if (polarity(*polPlanes[n], pt) == outPointPols[n]) {
+                    const double dist = (m_center - pt).norm();
+                    if (dist < dmin[n]) {
+                        dmin[n] = dist;
+                        points[n] = pt;
+                        found[n] = true;
+                    }
                 }
             }
         }
     }
-    HMDQ_ASSERT(found);
-    return point;
+    for (size_t n = 0; n < FOV_POINTS; ++n) {
+        HMDQ_ASSERT(found[n]);
+    }
+    return points;
 }
 
 } // namespace geom
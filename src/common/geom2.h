@@ -18,6 +18,8 @@
 #include <Eigen/Geometry>
 #include <Eigen/StdVector>
 
+#include <array>
+#include <utility>
 #include <vector>
 
 namespace geom {
@@ -26,6 +28,8 @@ namespace geom {
 //------------------------------------------------------------------------------
 constexpr double DOUBLE_EPS_100 = std::numeric_limits<double>::epsilon() * 100;
 constexpr double DOUBLE_MAX = std::numeric_limits<double>::max();
+//  Number of the FOV points (LB, B, RB, R, RT, T, LT, L)
+constexpr size_t FOV_POINTS = 8;
 
 //  typedefs
 //------------------------------------------------------------------------------
@@ -40,10 +44,35 @@ using PlaneArray = std::vector<Plane>;
 //  helper functions
 //------------------------------------------------------------------------------
 //  Convert faces to edges
-hedgelist_t faces_to_edges(const hfaces_t& faces);
+hedgelist_t faces_to_edges(const hcfaces_t& faces);
+//  Convert faces to edges (legacy face list)
+inline hedgelist_t faces_to_edges(const hfaces_t& faces)
+{
+    return faces_to_edges(to_cfaces(faces));
+}
 //  Calculate point "polarity" to the plane (whether it is above, below, or in the plane)
 int polarity(const Plane& plane, const Point3& point);
 
+//  struct EdgeLines
+//------------------------------------------------------------------------------
+//  Structure-of-arrays copy of the mesh edges as parametrized lines.
+struct EdgeLines {
+    //  Build the lines from the mesh vertices and edges
+    void build(const harray2d_t& verts, const hedgelist_t& edges);
+
+    size_t size() const
+    {
+        return limit.size();
+    }
+
+    // line origins (first edge vertex)
+    std::vector<double> ox, oy, oz;
+    // normalized line directions
+    std::vector<double> dx, dy, dz;
+    // edge lengths
+    std::vector<double> limit;
+};
+
 //  class Meshd
 //------------------------------------------------------------------------------
 //  Calculates the frustum FOV while incorporating the hidden area mesh (HAM) if present.
@@ -52,14 +81,33 @@ class Meshd
   public:
     Meshd() = default;
     Meshd(const Meshd& mesh) = default;
-    Meshd(const harray2d_t& verts, const hedgelist_t& edges)
-        : m_edges(edges)
-        , m_verts(verts)
+    Meshd(Meshd&& mesh) = default;
+    Meshd(harray2d_t verts, hedgelist_t edges)
+        : m_verts(std::move(verts))
+        , m_vcount(m_verts.shape(0))
+        , m_edges(std::move(edges))
     {}
 
+    Meshd& operator=(const Meshd& mesh) = default;
+    Meshd& operator=(Meshd&& mesh) = default;
+
+    //  Reserve the space for `nverts` vertices (with `ndim` coordinates) and `nedges`
+    //  edges in total, so the following additions do not reallocate.
+    void reserve(size_t nverts, size_t ndim, size_t nedges);
+
     //  Add another mesh to this to form one mesh
     void add_mesh(const harray2d_t& verts, const hedgelist_t& edges);
 
+    //  Add edges with the vertex indices shifted by `offset`
+    void add_edges(const hedgelist_t& edges, size_t offset = 0);
+
+    //  Get the number of vertices in the mesh
+    size_t vert_count() const
+    {
+        return m_vcount;
+    }
+
+    //  Get the vertex buffer (it may have more rows reserved than `vert_count`)
     const harray2d_t& get_verts() const
     {
         return m_verts;
@@ -72,29 +120,52 @@ class Meshd
 
   private:
     harray2d_t m_verts;
+    size_t m_vcount = 0;
     hedgelist_t m_edges;
 };
 
-//  class Frustum
+//  class FrustumMesh
 //------------------------------------------------------------------------------
-//  Calculates the frustum FOV while incorporating the hidden area mesh (HAM) if present.
-class Frustum
+//  HAM (if present) and the LRBT rectangle border lifted from the 2D UV space into the
+//  (not rotated) frustum projection plane. It is built once per eye and shared by the
+//  frustums with different rotations (e.g. eye and head view).
+class FrustumMesh
 {
   public:
-    Frustum(double left, double right, double bottom, double top,
-            const Rotation* pRot = nullptr, const Meshd* pHam = nullptr);
+    FrustumMesh(double left, double right, double bottom, double top,
+                const Meshd* pHam = nullptr);
 
-    //  Calculate all FOV points and put them into one array (LB, B, RB, ..)
-    harray2d_t get_fov_points(bool projected = false);
+    //  Build the mesh from the HAM vertices and edges (read in place, not copied)
+    FrustumMesh(double left, double right, double bottom, double top,
+                const harray2d_t& ham_verts, const hedgelist_t& ham_edges);
 
-  private:
-    //  Construct plane which cuts the frustum through center, given point and is aligned
-    //  with the view direction (vector forward).
-    Plane get_point_plane(const Point3& point)
+    double get_left() const
     {
-        return Plane::Through(m_center, point, m_forward);
+        return m_leftTan;
+    }
+
+    double get_right() const
+    {
+        return m_rightTan;
+    }
+
+    double get_bottom() const
+    {
+        return m_bottomTan;
+    }
+
+    double get_top() const
+    {
+        return m_topTan;
     }
 
+    //  Get the 3D mesh (HAM and the LRBT rectangle border)
+    const Meshd& get_mesh() const
+    {
+        return m_ham3d;
+    }
+
+  private:
     //  Create transformation from UV space into frustum LRBT rectangle
     Transform2 get_uv_to_lrbt_transform()
     {
@@ -103,11 +174,10 @@ class Frustum
         return res;
     }
 
-    //  Build 3D representation of the HAM inside the frustum from 2D UV definition
-    void get_ham_3d(const Meshd& ham2d, Meshd& ham3d);
-
-    //  Calculate one "raw" FOV point as an intersection of a "point-plane" and the HAM
-    Point3 get_raw_fov_point(size_t n);
+    //  Build 3D representation of the HAM (the first `hcount` vertices of `pVerts`, if
+    //  any) and the LRBT rectangle border inside the frustum from 2D UV definition
+    void get_ham_3d(const harray2d_t* pVerts, size_t hcount, const hedgelist_t* pEdges,
+                    Meshd& ham3d);
 
   private:
     double m_leftTan;
@@ -115,6 +185,44 @@ class Frustum
     double m_bottomTan;
     double m_topTan;
 
+    Meshd m_ham3d;
+};
+
+//  class Frustum
+//------------------------------------------------------------------------------
+//  Calculates the frustum FOV while incorporating the hidden area mesh (HAM) if present.
+class Frustum
+{
+  public:
+    Frustum(double left, double right, double bottom, double top,
+            const Rotation* pRot = nullptr, const Meshd* pHam = nullptr)
+        : Frustum(FrustumMesh(left, right, bottom, top, pHam), pRot)
+    {}
+
+    //  Build the frustum from the prepared mesh, rotated by `pRot` (if given)
+    Frustum(const FrustumMesh& mesh, const Rotation* pRot = nullptr);
+
+    //  Calculate all FOV points and put them into one array (LB, B, RB, ..)
+    harray2d_t get_fov_points(bool projected = false);
+
+    //  Calculate the FOV profile, i.e. the FOV outline points at `count` polar angles
+    //  (evenly spaced, counter-clockwise from the right direction) around the view
+    //  axis.
+    harray2d_t get_fov_profile(size_t count, bool projected = false) const;
+
+  private:
+    //  Construct plane which cuts the frustum through center, given point and is aligned
+    //  with the view direction (vector forward).
+    Plane get_point_plane(const Point3& point)
+    {
+        return Plane::Through(m_center, point, m_forward);
+    }
+
+    //  Calculate all "raw" FOV points as intersections of the "point-planes" and the HAM
+    //  edges.
+    Point3Array get_raw_fov_points() const;
+
+  private:
     Point3 m_center;
     Point3 m_forward;
     Point3 m_leftBottom;
@@ -126,8 +234,7 @@ class Frustum
     Point3 m_leftTop;
     Point3 m_left;
 
-    const Rotation* m_pRot;
-    Meshd m_ham3d;
+    EdgeLines m_hamLines;
 
     Point3Array m_outPoints;
     PlaneArray m_pointPlanes;
@@ -0,0 +1,85 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <common/xtdef.h>
+
+#include <array>
+#include <optional>
+#include <vector>
+
+//  globals
+//------------------------------------------------------------------------------
+//  Eye indexes in the per eye arrays
+constexpr size_t LEYE = 0;
+constexpr size_t REYE = 1;
+constexpr size_t EYES = 2;
+
+//  typedefs
+//------------------------------------------------------------------------------
+//  Raw eye frustum (tangents of the LRBT angles)
+struct RawEye {
+    double left = 0.0;
+    double right = 0.0;
+    double bottom = 0.0;
+    double top = 0.0;
+};
+
+//  Hidden area mesh of one eye
+struct HamMesh {
+    harray2d_t verts_raw; // recorded vertices
+    hcfaces_t faces_raw; // recorded (or computed) faces
+    bool faces_raw_computed = false; // faces were built for a plain triangle list
+    harray2d_t verts_opt; // optimized vertices
+    hcfaces_t faces_opt; // optimized faces
+    std::optional<double> ham_area; // HAM area (relative to the render target)
+};
+
+//  FOV of one eye
+struct EyeFov {
+    harray2d_t fov_pts; // FOV points (LB, B, RB, R, RT, T, LT, L)
+    double deg_left = 0.0;
+    double deg_right = 0.0;
+    double deg_bottom = 0.0;
+    double deg_top = 0.0;
+    double deg_hor = 0.0;
+    double deg_ver = 0.0;
+    std::vector<double> fov_profile; // FOV profile (empty if not computed)
+};
+
+//  Total FOV of both eyes
+struct TotalFov {
+    double fov_hor = 0.0;
+    double fov_ver = 0.0;
+    double fov_diag = 0.0;
+    double overlap = 0.0;
+};
+
+//  View geometry (canted views and IPD)
+struct ViewGeom {
+    double left_rot = 0.0;
+    double right_rot = 0.0;
+    double ipd = 0.0;
+};
+
+//  Geometry data (input and computed) of one headset
+struct Geometry {
+    // inputs
+    std::array<RawEye, EYES> raw_eye;
+    std::array<harray2d_t, EYES> eye2head;
+    std::array<std::optional<HamMesh>, EYES> ham_mesh;
+    // results
+    ViewGeom view_geom;
+    std::array<std::optional<EyeFov>, EYES> fov_eye;
+    std::array<EyeFov, EYES> fov_head;
+    TotalFov fov_tot;
+};
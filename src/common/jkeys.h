@@ -105,6 +105,7 @@ constexpr const char* j_deg_bottom = "deg_bottom";
 constexpr const char* j_deg_top = "deg_top";
 constexpr const char* j_deg_hor = "deg_hor";
 constexpr const char* j_deg_ver = "deg_ver";
+constexpr const char* j_fov_profile = "fov_profile";
 
 constexpr const char* j_fov_tot = "fov_tot";
 constexpr const char* j_fov_hor = "fov_hor";
@@ -9,6 +9,7 @@
  * SPDX-License-Identifier: BSD-3-Clause                                      *
  ******************************************************************************/
 
+#include <common/archive.h>
 #include <common/config.h>
 #include <common/except.h>
 #include <common/jkeys.h>
@@ -16,43 +17,912 @@
 #include <common/jtools.h>
 #include <common/wintools.h>
 
-#include <botan/filters.h>
 #include <botan/hash.h>
 #include <botan/hex.h>
-#include <botan/pipe.h>
 
 #include <fmt/format.h>
 #include <fmt/ranges.h>
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
+//  Binary formats
+//------------------------------------------------------------------------------
+//  Subtype of binary values holding typed arrays, it is the CBOR tag (RFC 8746) of
+//  IEEE 754 binary64 little endian typed array (and also MessagePack ext type).
+constexpr std::uint8_t TYPED_ARRAY_F64LE = 86;
+
+static_assert(std::endian::native == std::endian::little,
+              "typed arrays are stored in the native byte order");
+
+//  Return the shape of float vector or matrix, or an empty shape if `jd` is neither.
+static std::vector<size_t> float_array_shape(const json& jd)
+{
+    const auto is_float = [](const json& v) { return v.is_number_float(); };
+    if (!jd.is_array() || jd.empty()) {
+        return {};
+    }
+    if (!jd.front().is_array()) {
+        if (std::all_of(jd.begin(), jd.end(), is_float)) {
+            return {jd.size()};
+        }
+        return {};
+    }
+    const auto cols = jd.front().size();
+    for (const auto& row : jd) {
+        if (!row.is_array() || row.size() != cols || cols == 0
+            || !std::all_of(row.begin(), row.end(), is_float)) {
+            return {};
+        }
+    }
+    return {jd.size(), cols};
+}
+
+//  Return the float vector or matrix (with the shape from `float_array_shape`) as
+//  typed array stored as [shape, binary].
+static json pack_float_array(const json& jd, const std::vector<size_t>& shape)
+{
+    std::vector<std::uint8_t> bytes;
+    const auto append = [&bytes](const json& val) {
+        const auto d = val.get<double>();
+        const auto* p = reinterpret_cast<const std::uint8_t*>(&d);
+        bytes.insert(bytes.end(), p, p + sizeof(d));
+    };
+    if (shape.size() == 1) {
+        bytes.reserve(shape[0] * sizeof(double));
+        std::for_each(jd.begin(), jd.end(), append);
+    } else {
+        bytes.reserve(shape[0] * shape[1] * sizeof(double));
+        for (const auto& row : jd) {
+            std::for_each(row.begin(), row.end(), append);
+        }
+    }
+    return json::array({json(shape), json::binary(std::move(bytes), TYPED_ARRAY_F64LE)});
+}
+
+//  Read the next value from the typed array bytes.
+static double read_f64(const std::uint8_t*& next)
+{
+    double d;
+    std::memcpy(&d, next, sizeof(d));
+    next += sizeof(d);
+    return d;
+}
+
+//  Restore float vectors and matrices from typed arrays.
+static void unpack_float_arrays(json& jd)
+{
+    if (jd.is_object()) {
+        for (auto& [key, val] : jd.items()) {
+            unpack_float_arrays(val);
+        }
+    } else if (jd.is_array()) {
+        if (jd.size() != 2 || !jd[1].is_binary() || !jd[1].get_binary().has_subtype()
+            || jd[1].get_binary().subtype() != TYPED_ARRAY_F64LE) {
+            for (auto& val : jd) {
+                unpack_float_arrays(val);
+            }
+            return;
+        }
+        const auto shape = jd[0].get<std::vector<size_t>>();
+        const auto& bytes = jd[1].get_binary();
+        HMDQ_ASSERT(shape.size() == 1 || shape.size() == 2);
+        const auto cols = shape.size() == 1 ? 0 : shape[1];
+        const auto count = shape[0] * std::max<size_t>(cols, 1);
+        HMDQ_ASSERT(bytes.size() == count * sizeof(double));
+        const std::uint8_t* next = bytes.data();
+        json res = json::array();
+        for (size_t i = 0; i < shape[0]; ++i) {
+            if (cols == 0) {
+                res.push_back(read_f64(next));
+                continue;
+            }
+            json row = json::array();
+            for (size_t j = 0; j < cols; ++j) {
+                row.push_back(read_f64(next));
+            }
+            res.push_back(std::move(row));
+        }
+        jd = std::move(res);
+    }
+}
+
+//  Detect the data format from the first byte (all data files have an object at the
+//  top level, so it is either '{' (or BOM, or whitespace), CBOR map, or MessagePack
+//  map).
+static jformat detect_jformat(const char* first, const char* last)
+{
+    if (first == last) {
+        return jformat::json;
+    }
+    const auto b = static_cast<std::uint8_t>(*first);
+    if (b >= 0xa0 && b <= 0xbf) {
+        return jformat::cbor;
+    }
+    if ((b >= 0x80 && b <= 0x8f) || b == 0xde || b == 0xdf) {
+        return jformat::msgpack;
+    }
+    return jformat::json;
+}
+
+//  Parse the data in the buffer in any supported format.
+static json parse_data(const char* first, const char* last)
+{
+    json res;
+    switch (detect_jformat(first, last)) {
+        case jformat::cbor:
+            res = json::from_cbor(first, last, true, true,
+                                  json::cbor_tag_handler_t::store);
+            unpack_float_arrays(res);
+            break;
+        case jformat::msgpack:
+            res = json::from_msgpack(first, last);
+            unpack_float_arrays(res);
+            break;
+        default:
+            res = json::parse(first, last);
+            break;
+    }
+    return res;
+}
+
+//  SAX handler adapter which passes the typed arrays ([shape, binary] from the binary
+//  formats) to the handler as the float vectors and matrices, all other events are
+//  passed as they are. The events which may start a typed array are held back until
+//  it is clear whether they do.
+class TypedArraySax : public nlohmann::json_sax<json>
+{
+  public:
+    explicit TypedArraySax(nlohmann::json_sax<json>& sax)
+        : m_sax(sax)
+    {}
+
+    bool null() override
+    {
+        return m_pending.empty() ? m_sax.null() : feed({Kind::null});
+    }
+    bool boolean(bool val) override
+    {
+        return m_pending.empty() ? m_sax.boolean(val) : feed({Kind::boolean, val});
+    }
+    bool number_integer(number_integer_t val) override
+    {
+        return m_pending.empty() ? m_sax.number_integer(val)
+                                 : feed({Kind::number_integer, val});
+    }
+    bool number_unsigned(number_unsigned_t val) override
+    {
+        return m_pending.empty() ? m_sax.number_unsigned(val)
+                                 : feed({Kind::number_unsigned, val});
+    }
+    bool number_float(number_float_t val, const string_t& s) override
+    {
+        return m_pending.empty() ? m_sax.number_float(val, s)
+                                 : feed({Kind::number_float, val});
+    }
+    bool string(string_t& val) override
+    {
+        return m_pending.empty() ? m_sax.string(val)
+                                 : feed({Kind::string, std::move(val)});
+    }
+    bool binary(binary_t& val) override
+    {
+        return m_pending.empty() ? m_sax.binary(val)
+                                 : feed({Kind::binary, std::move(val)});
+    }
+    bool start_object(std::size_t size) override
+    {
+        return m_pending.empty() ? m_sax.start_object(size)
+                                 : feed({Kind::start_object, nullptr, size});
+    }
+    bool key(string_t& val) override
+    {
+        return m_pending.empty() ? m_sax.key(val) : feed({Kind::key, std::move(val)});
+    }
+    bool end_object() override
+    {
+        return m_pending.empty() ? m_sax.end_object() : feed({Kind::end_object});
+    }
+    bool start_array(std::size_t size) override
+    {
+        // the typed array is an array of two (shape and binary)
+        return (m_pending.empty() && size != 2)
+            ? m_sax.start_array(size)
+            : feed({Kind::start_array, nullptr, size});
+    }
+    bool end_array() override
+    {
+        return m_pending.empty() ? m_sax.end_array() : feed({Kind::end_array});
+    }
+    bool parse_error(std::size_t pos, const std::string& token,
+                     const nlohmann::detail::exception& ex) override
+    {
+        return m_sax.parse_error(pos, token, ex);
+    }
+
+  private:
+    enum class Kind {
+        null,
+        boolean,
+        number_integer,
+        number_unsigned,
+        number_float,
+        string,
+        binary,
+        start_object,
+        key,
+        end_object,
+        start_array,
+        end_array,
+    };
+
+    //  Held back event (with its value or container size)
+    struct Event {
+        Kind kind;
+        json val;
+        std::size_t size = 0;
+    };
+
+    enum class Match { partial, complete, mismatch };
+
+    //  Hold back the event and pass on the pending events once they are resolved.
+    bool feed(Event&& ev)
+    {
+        if (m_pending.empty()
+            && (ev.kind != Kind::start_array || ev.size != 2)) {
+            return emit(ev);
+        }
+        m_pending.push_back(std::move(ev));
+        switch (match()) {
+            case Match::partial:
+                return true;
+            case Match::complete: {
+                const bool ok = emit_typed_array();
+                m_pending.clear();
+                return ok;
+            }
+            default:
+                break;
+        }
+        // pass on the first event, the others may still start a typed array
+        auto events = std::move(m_pending);
+        m_pending.clear();
+        bool ok = emit(events.front());
+        for (size_t i = 1; i < events.size(); ++i) {
+            ok = feed(std::move(events[i])) && ok;
+        }
+        return ok;
+    }
+
+    //  Match the pending events against the typed array pattern:
+    //  start_array(2), start_array(ndim), ndim x number_unsigned, end_array, binary,
+    //  end_array
+    Match match() const
+    {
+        const auto& p = m_pending;
+        const size_t count = p.size();
+        if (count < 2) {
+            return Match::partial;
+        }
+        const auto ndim = p[1].size;
+        if (p[1].kind != Kind::start_array || (ndim != 1 && ndim != 2)) {
+            return Match::mismatch;
+        }
+        for (size_t i = 2; i < std::min(count, ndim + 2); ++i) {
+            if (p[i].kind != Kind::number_unsigned) {
+                return Match::mismatch;
+            }
+        }
+        const auto ishape_end = ndim + 2;
+        if (count > ishape_end && p[ishape_end].kind != Kind::end_array) {
+            return Match::mismatch;
+        }
+        const auto ibin = ishape_end + 1;
+        if (count > ibin
+            && (p[ibin].kind != Kind::binary || !p[ibin].val.get_binary().has_subtype()
+                || p[ibin].val.get_binary().subtype() != TYPED_ARRAY_F64LE)) {
+            return Match::mismatch;
+        }
+        const auto iend = ibin + 1;
+        if (count > iend) {
+            return p[iend].kind == Kind::end_array ? Match::complete : Match::mismatch;
+        }
+        return Match::partial;
+    }
+
+    //  Pass on the pending typed array as the float vector or matrix.
+    bool emit_typed_array()
+    {
+        const auto ndim = m_pending[1].size;
+        const auto rows = m_pending[2].val.get<size_t>();
+        const auto cols = ndim == 1 ? 0 : m_pending[3].val.get<size_t>();
+        const auto& bytes = m_pending[ndim + 3].val.get_binary();
+        HMDQ_ASSERT(bytes.size() == rows * std::max<size_t>(cols, 1) * sizeof(double));
+        const std::uint8_t* next = bytes.data();
+        const string_t no_str;
+        bool ok = m_sax.start_array(rows);
+        for (size_t i = 0; i < rows; ++i) {
+            if (cols == 0) {
+                ok = m_sax.number_float(read_f64(next), no_str) && ok;
+                continue;
+            }
+            ok = m_sax.start_array(cols) && ok;
+            for (size_t j = 0; j < cols; ++j) {
+                ok = m_sax.number_float(read_f64(next), no_str) && ok;
+            }
+            ok = m_sax.end_array() && ok;
+        }
+        return m_sax.end_array() && ok;
+    }
+
+    //  Pass on the event.
+    bool emit(Event& ev)
+    {
+        switch (ev.kind) {
+            case Kind::null:
+                return m_sax.null();
+            case Kind::boolean:
+                return m_sax.boolean(ev.val.get<bool>());
+            case Kind::number_integer:
+                return m_sax.number_integer(ev.val.get<number_integer_t>());
+            case Kind::number_unsigned:
+                return m_sax.number_unsigned(ev.val.get<number_unsigned_t>());
+            case Kind::number_float:
+                return m_sax.number_float(ev.val.get<number_float_t>(), string_t());
+            case Kind::string:
+                return m_sax.string(ev.val.get_ref<string_t&>());
+            case Kind::binary:
+                return m_sax.binary(ev.val.get_binary());
+            case Kind::start_object:
+                return m_sax.start_object(ev.size);
+            case Kind::key:
+                return m_sax.key(ev.val.get_ref<string_t&>());
+            case Kind::end_object:
+                return m_sax.end_object();
+            case Kind::start_array:
+                return m_sax.start_array(ev.size);
+            case Kind::end_array:
+                return m_sax.end_array();
+        }
+        return false;
+    }
+
+  private:
+    nlohmann::json_sax<json>& m_sax;
+    std::vector<Event> m_pending;
+};
+
+//  Parse the data in the buffer in any supported format with the SAX handler, the
+//  typed arrays from the binary formats are passed to it as float vectors and matrices.
+static bool sax_parse_data(const char* first, const char* last,
+                           nlohmann::json_sax<json>& sax)
+{
+    const auto format = detect_jformat(first, last);
+    if (format == jformat::json) {
+        return json::sax_parse(first, last, &sax);
+    }
+    const auto iformat = (format == jformat::cbor) ? json::input_format_t::cbor
+                                                   : json::input_format_t::msgpack;
+    TypedArraySax tsax(sax);
+    // `json::sax_parse` rejects the CBOR tags (of the typed arrays), the reader is used
+    // directly to keep them (as `from_cbor` does)
+    auto input = nlohmann::detail::input_adapter(first, last);
+    nlohmann::detail::binary_reader<json, decltype(input), TypedArraySax> reader(
+        std::move(input), iformat);
+    return reader.sax_parse(iformat, &tsax, true, json::cbor_tag_handler_t::store);
+}
+
+//  Serialization
+//------------------------------------------------------------------------------
+//  JSON serializer output adapter which collects the serialized data in a small buffer
+//  and passes it to the sink (a file, or a hash function) when the buffer is full.
+class BufferedOutputAdapter : public nlohmann::detail::output_adapter_protocol<char>
+{
+  public:
+    using sink_t = std::function<void(const char*, size_t)>;
+
+    explicit BufferedOutputAdapter(sink_t sink)
+        : m_sink(std::move(sink))
+    {}
+
+    void write_character(char c) override
+    {
+        if (m_size == m_buffer.size()) {
+            flush();
+        }
+        m_buffer[m_size++] = c;
+    }
+
+    void write_characters(const char* s, std::size_t length) override
+    {
+        if (m_size + length > m_buffer.size()) {
+            flush();
+            if (length >= m_buffer.size()) {
+                // too big to buffer, pass it directly
+                m_sink(s, length);
+                return;
+            }
+        }
+        std::copy(s, s + length, m_buffer.data() + m_size);
+        m_size += length;
+    }
+
+    //  Push the buffered data into the sink.
+    void flush()
+    {
+        if (m_size) {
+            m_sink(m_buffer.data(), m_size);
+            m_size = 0;
+        }
+    }
+
+  private:
+    sink_t m_sink;
+    std::array<char, 4096> m_buffer;
+    size_t m_size = 0;
+};
+
+//  JSON serializer output adapter which writes the same data into two adapters (the
+//  second one is optional).
+class TeeOutputAdapter : public nlohmann::detail::output_adapter_protocol<char>
+{
+  public:
+    using adapter_t = nlohmann::detail::output_adapter_t<char>;
+
+    TeeOutputAdapter(adapter_t first, adapter_t second)
+        : m_first(std::move(first))
+        , m_second(std::move(second))
+    {}
+
+    void write_character(char c) override
+    {
+        m_first->write_character(c);
+        if (m_second) {
+            m_second->write_character(c);
+        }
+    }
+
+    void write_characters(const char* s, std::size_t length) override
+    {
+        m_first->write_characters(s, length);
+        if (m_second) {
+            m_second->write_characters(s, length);
+        }
+    }
+
+    //  Stop writing into the second adapter.
+    void detach_second()
+    {
+        m_second.reset();
+    }
+
+  private:
+    adapter_t m_first;
+    adapter_t m_second;
+};
+
+//  JSON writer which serializes the document in one pass into the output (with
+//  indentation, as `json::dump(indent)` does) and into the hash (in the compact form,
+//  as `json::dump()` does). Either of them can be null.
+class JsonWriter
+{
+  public:
+    using adapter_t = nlohmann::detail::output_adapter_t<char>;
+
+    JsonWriter(adapter_t out, adapter_t hash, int indent)
+        : m_out(out)
+        , m_hash(hash)
+        , m_pretty(out && indent >= 0)
+        , m_indent(indent >= 0 ? indent : 0)
+        , m_tee(std::make_shared<TeeOutputAdapter>(out ? out : hash,
+                                                   out ? hash : nullptr))
+        , m_ser(m_tee, ' ')
+    {}
+
+    //  Write the value, leave out the top level property `skip_key` (if not null).
+    void write(const json& jd, const char* skip_key = nullptr)
+    {
+        if (!jd.is_object() || nullptr == skip_key) {
+            value(jd);
+            return;
+        }
+        begin_object();
+        for (const auto& [key, val] : jd.items()) {
+            if (key != skip_key) {
+                member(key, val);
+            }
+        }
+        end_object();
+    }
+
+    //  Open an object (write the members with `member` and close it with `end_object`).
+    void begin_object()
+    {
+        m_tee->write_character('{');
+        m_first.push_back(true);
+    }
+
+    //  Write the object member.
+    void member(const std::string& key, const json& val)
+    {
+        separator();
+        m_ser.dump(json(key), false, false, 0);
+        m_tee->write_character(':');
+        if (m_pretty) {
+            m_out->write_character(' ');
+        }
+        value(val);
+    }
+
+    //  Close the object opened by `begin_object`.
+    void end_object()
+    {
+        close('}');
+    }
+
+    //  Close the (top level) object in the hash and stop writing into it, the rest goes
+    //  only into the output.
+    void detach_hash()
+    {
+        HMDQ_ASSERT(m_out && m_hash && m_first.size() == 1);
+        m_hash->write_character('}');
+        m_tee->detach_second();
+        m_hash.reset();
+    }
+
+  private:
+    void value(const json& jd)
+    {
+        if (!m_pretty || !m_hash) {
+            // single output (or the same form in both), let the serializer do the job
+            const auto current = static_cast<unsigned>(m_first.size()) * m_indent;
+            m_ser.dump(jd, m_pretty, false, m_indent, current);
+        } else if (jd.is_object() && !jd.empty()) {
+            begin_object();
+            for (const auto& [key, val] : jd.items()) {
+                member(key, val);
+            }
+            end_object();
+        } else if (jd.is_array() && !jd.empty()) {
+            m_tee->write_character('[');
+            m_first.push_back(true);
+            for (const auto& val : jd) {
+                separator();
+                value(val);
+            }
+            close(']');
+        } else {
+            // scalars and empty containers are the same in both forms
+            m_ser.dump(jd, false, false, 0);
+        }
+    }
+
+    //  Write the separator before the next item of the container.
+    void separator()
+    {
+        if (!m_first.back()) {
+            m_tee->write_character(',');
+        }
+        m_first.back() = false;
+        new_line(m_first.size());
+    }
+
+    //  Close the container.
+    void close(char c)
+    {
+        const bool empty = m_first.back();
+        m_first.pop_back();
+        if (!empty) {
+            new_line(m_first.size());
+        }
+        m_tee->write_character(c);
+    }
+
+    //  Start a new line with the indentation of `level` (only in the output).
+    void new_line(size_t level)
+    {
+        if (m_pretty) {
+            const auto width = level * m_indent;
+            if (m_spaces.size() < width) {
+                m_spaces.resize(width * 2, ' ');
+            }
+            m_out->write_character('\n');
+            m_out->write_characters(m_spaces.data(), width);
+        }
+    }
+
+  private:
+    adapter_t m_out;
+    adapter_t m_hash;
+    bool m_pretty;
+    unsigned m_indent;
+    std::shared_ptr<TeeOutputAdapter> m_tee;
+    nlohmann::detail::serializer<json> m_ser;
+    std::vector<bool> m_first; // no item written yet into the open container
+    std::string m_spaces;
+};
+
+//  Binary (CBOR or MessagePack) writer which serializes the document into the output
+//  and packs the float vectors and matrices into typed arrays on the way.
+class BinaryWriter
+{
+  public:
+    using adapter_t = nlohmann::detail::output_adapter_t<char>;
+
+    BinaryWriter(adapter_t out, jformat format)
+        : m_out(out)
+        , m_cbor(format == jformat::cbor)
+        , m_writer(out)
+    {
+        HMDQ_ASSERT(format == jformat::cbor || format == jformat::msgpack);
+    }
+
+    //  Write the value.
+    void write(const json& jd)
+    {
+        if (jd.is_object()) {
+            begin_object(jd.size());
+            for (const auto& [key, val] : jd.items()) {
+                member(key, val);
+            }
+        } else if (jd.is_array()) {
+            const auto shape = float_array_shape(jd);
+            if (!shape.empty()) {
+                scalar(pack_float_array(jd, shape));
+                return;
+            }
+            header(false, jd.size());
+            for (const auto& val : jd) {
+                write(val);
+            }
+        } else {
+            scalar(jd);
+        }
+    }
+
+    //  Open an object with `size` members (written with `member`).
+    void begin_object(size_t size)
+    {
+        header(true, size);
+    }
+
+    //  Write the object member.
+    void member(const std::string& key, const json& val)
+    {
+        scalar(json(key));
+        write(val);
+    }
+
+  private:
+    //  Write the value as it is (containers included).
+    void scalar(const json& jd)
+    {
+        if (m_cbor) {
+            m_writer.write_cbor(jd);
+        } else {
+            m_writer.write_msgpack(jd);
+        }
+    }
+
+    //  Write the map or array header, in the same (shortest) form as the library.
+    void header(bool map, size_t size)
+    {
+        if (m_cbor) {
+            const std::uint8_t major = map ? 0xa0 : 0x80;
+            if (size <= 0x17) {
+                put(major + size, 0);
+            } else if (size <= 0xff) {
+                put(major + 0x18, 0);
+                put(size, 1);
+            } else if (size <= 0xffff) {
+                put(major + 0x19, 0);
+                put(size, 2);
+            } else if (size <= 0xffffffff) {
+                put(major + 0x1a, 0);
+                put(size, 4);
+            } else {
+                put(major + 0x1b, 0);
+                put(size, 8);
+            }
+        } else {
+            if (size <= 0x0f) {
+                put((map ? 0x80 : 0x90) | size, 0);
+            } else if (size <= 0xffff) {
+                put(map ? 0xde : 0xdc, 0);
+                put(size, 2);
+            } else {
+                HMDQ_ASSERT(size <= 0xffffffff);
+                put(map ? 0xdf : 0xdd, 0);
+                put(size, 4);
+            }
+        }
+    }
+
+    //  Write the value as `nbytes` big endian bytes (or as one byte if `nbytes` is 0).
+    void put(uint64_t val, size_t nbytes)
+    {
+        if (nbytes == 0) {
+            m_out->write_character(static_cast<char>(val));
+            return;
+        }
+        for (size_t i = nbytes; i > 0; --i) {
+            m_out->write_character(static_cast<char>(val >> ((i - 1) * 8)));
+        }
+    }
+
+  private:
+    adapter_t m_out;
+    bool m_cbor;
+    nlohmann::detail::binary_writer<json, char> m_writer;
+};
+
+//  Create the hash function used for the checksum.
+static std::unique_ptr<Botan::HashFunction> create_checksum_hash()
+{
+    const auto hash_name = fmt::format("Blake2b({:d})", CHKSUM_BITSIZE);
+    return Botan::HashFunction::create_or_throw(hash_name);
+}
+
+//  Create the serializer output adapter feeding the hash function.
+static std::shared_ptr<BufferedOutputAdapter> make_hash_adapter(Botan::HashFunction& hash)
+{
+    return std::make_shared<BufferedOutputAdapter>([&hash](const char* s, size_t n) {
+        hash.update(reinterpret_cast<const uint8_t*>(s), n);
+    });
+}
+
+//  Calculate the hash over the compact JSON dump (the same as `jd.dump()`) without
+//  creating the dump. If `skip_key` is not null, the top level property of that name
+//  is left out as if it was not in `jd`.
+static std::string hash_json(const json& jd, const char* skip_key)
+{
+    auto b2b = create_checksum_hash();
+    auto hash = make_hash_adapter(*b2b);
+    // use the most efficient form for checksum (indent=-1)
+    JsonWriter(nullptr, hash, -1).write(jd, skip_key);
+    hash->flush();
+    return Botan::hex_encode(b2b->final());
+}
+
 //  JSON file I/O
 //------------------------------------------------------------------------------
-//  Read and parse JSON file, return json data.
-json read_json(const std::filesystem::path& inpath)
+//  Read the whole file into the memory (fallback if the file cannot be mapped).
+static std::vector<char> read_file(const std::filesystem::path& inpath)
+{
+    std::ifstream fin(inpath, std::ios::binary);
+    if (!fin) {
+        auto msg = fmt::format("Cannot open file: \"{:s}\"", path_to_utf8(inpath));
+        throw hmdq_error(msg);
+    }
+    std::vector<char> buffer(std::filesystem::file_size(inpath));
+    fin.read(buffer.data(), buffer.size());
+    buffer.resize(fin.gcount());
+    return buffer;
+}
+
+//  Call `parse(first, last)` over the file content in one contiguous buffer. The archive
+//  entries ("<archive>#<selector>") are parsed directly from the (shared) archive.
+template <typename F>
+static auto parse_file(const std::filesystem::path& inpath, F&& parse)
 {
+    std::filesystem::path apath;
+    std::string selector;
+    if (split_archive_path(inpath, apath, selector)) {
+        const auto parc = open_archive(apath);
+        return parc->with_data(parc->select_one(selector), parse);
+    }
     if (!std::filesystem::exists(inpath)) {
         auto msg = fmt::format("File not found: \"{:s}\"", path_to_utf8(inpath));
         throw hmdq_error(msg);
     }
 
-    // read JSON data input
-    std::ifstream jin(inpath);
-    json jdata;
-    jin >> jdata;
-    jin.close();
-    return jdata;
+    const MappedFile mfile(inpath);
+    if (mfile.is_mapped()) {
+        return parse(mfile.data(), mfile.data() + mfile.size());
+    }
+    const auto buffer = read_file(inpath);
+    return parse(buffer.data(), buffer.data() + buffer.size());
 }
 
-// Save JSON data into file with indentation.
-void write_json(const std::filesystem::path& outpath, const json& jdata, int indent)
+//  Read and parse JSON file, return json data.
+json read_json(const std::filesystem::path& inpath)
 {
-    std::ofstream jfo(outpath);
-    jfo << jdata.dump(indent);
+    return parse_file(inpath, parse_data);
+}
+
+//  Return the raw content of the data file.
+std::vector<char> read_data(const std::filesystem::path& inpath)
+{
+    return parse_file(inpath, [](const char* first, const char* last) {
+        return std::vector<char>(first, last);
+    });
+}
+
+//  Parse JSON file with a custom SAX handler.
+bool sax_parse_json(const std::filesystem::path& inpath, nlohmann::json_sax<json>& sax)
+{
+    return parse_file(inpath, [&sax](const char* first, const char* last) {
+        return sax_parse_data(first, last, sax);
+    });
+}
+
+// Save JSON data into file with indentation (or in the binary format).
+void write_json(const std::filesystem::path& outpath, const json& jdata, int indent,
+                jformat format, bool with_checksum)
+{
+    HMDQ_ASSERT(!with_checksum || jdata.is_object());
+    // serialize directly into the file (and into the hash for the checksum)
+    const auto mode
+        = (format == jformat::json) ? std::ios::out : std::ios::out | std::ios::binary;
+    std::ofstream jfo(outpath, mode);
+    if (!jfo) {
+        auto msg = fmt::format("Cannot create file: \"{:s}\"", path_to_utf8(outpath));
+        throw hmdq_error(msg);
+    }
+    auto file = std::make_shared<BufferedOutputAdapter>(
+        [&jfo](const char* s, size_t n) { jfo.write(s, n); });
+    if (format != jformat::json) {
+        BinaryWriter writer(file, format);
+        if (!with_checksum) {
+            writer.write(jdata);
+        } else {
+            // the checksum (over the JSON form) goes last
+            const auto checksum = hash_json(jdata, j_checksum);
+            writer.begin_object(jdata.size() + (jdata.contains(j_checksum) ? 0 : 1));
+            for (const auto& [key, val] : jdata.items()) {
+                if (key != j_checksum) {
+                    writer.member(key, val);
+                }
+            }
+            writer.member(j_checksum, checksum);
+        }
+    } else if (!with_checksum) {
+        JsonWriter(file, nullptr, indent).write(jdata);
+    } else {
+        auto b2b = create_checksum_hash();
+        auto hash = make_hash_adapter(*b2b);
+        JsonWriter writer(file, hash, indent);
+        writer.begin_object();
+        for (const auto& [key, val] : jdata.items()) {
+            if (key != j_checksum) {
+                writer.member(key, val);
+            }
+        }
+        // the checksum goes last, calculated over everything before
+        writer.detach_hash();
+        hash->flush();
+        writer.member(j_checksum, Botan::hex_encode(b2b->final()));
+        writer.end_object();
+    }
+    file->flush();
     jfo.close();
+    if (!jfo) {
+        auto msg = fmt::format("Cannot write file: \"{:s}\"", path_to_utf8(outpath));
+        throw hmdq_error(msg);
+    }
+}
+
+//  Return the data format for its name.
+jformat get_jformat(const std::string& name)
+{
+    if (name == "json") {
+        return jformat::json;
+    } else if (name == "cbor") {
+        return jformat::cbor;
+    } else if (name == "msgpack") {
+        return jformat::msgpack;
+    }
+    throw hmdq_error(fmt::format("Unknown data format: \"{}\"", name));
 }
 
 //  Anonymize functions
@@ -81,21 +951,25 @@ void anonymize(std::vector<char>& out, const std::vector<char>& in)
 //  Return (string) property value for given property from properties
 inline std::string get_prop_val(const json& jdprops, const std::string& pname)
 {
-    if (jdprops.contains(pname) && jdprops[pname].is_string())
-        return jdprops[pname].get<std::string>();
+    // single lookup (`json` is ordered, i.e. the lookup is a linear search)
+    const auto it = jdprops.find(pname);
+    if (it != jdprops.end() && it->is_string())
+        return it->get<std::string>();
     else {
         return "";
     }
 }
 
 //  Anonymize properties in JSON list
-void anonymize_jdprops(json& jdprops, const std::vector<std::string>& anon_prop_names,
+void anonymize_jdprops(json& jdprops, const std::unordered_set<std::string>& anon_props,
                        const std::vector<std::string>& seed_prop_names)
 {
-    // get the list of properties to hash from the config file
+    // the properties to hash are from the config file
     const std::string anon_prefix(ANON_PREFIX);
-    for (const auto pname : anon_prop_names) {
-        const auto pval = get_prop_val(jdprops, pname);
+    for (auto& [pname, jval] : jdprops.items()) {
+        if (!anon_props.contains(pname) || !jval.is_string())
+            continue;
+        const auto pval = jval.get<std::string>();
         if (pval.size() == 0)
             continue;
         // hash only non-empty strings
@@ -110,7 +984,7 @@ void anonymize_jdprops(json& jdprops, const std::vector<std::string>& anon_prop_
             msgbuff.push_back('\0');
             std::vector<char> buffer;
             anonymize(buffer, msgbuff);
-            jdprops[pname] = &buffer[0];
+            jval = &buffer[0];
         }
     }
 }
@@ -177,11 +1051,7 @@ std::string get_error_msg(const json& jd)
 //  The returned value is an upper case string of a binhex encoded hash.
 std::string calculate_checksum(const json& jd)
 {
-    const auto hash_name = fmt::format("Blake2b({:d})", CHKSUM_BITSIZE);
-    Botan::Pipe pipe(new Botan::Hash_Filter(hash_name), new Botan::Hex_Encoder);
-    // use the most efficient form for checksum (indent=-1)
-    pipe.process_msg(jd.dump());
-    return pipe.read_all_as_string();
+    return hash_json(jd, nullptr);
 }
 
 //  Verify the checksum in the JSON dics (if there is one)
@@ -190,9 +1060,302 @@ bool verify_checksum(const json& jd)
     if (!has_checksum(jd))
         return false;
 
-    json jcopy = jd;
-    const auto chksm = jcopy[j_checksum].get<std::string>();
-    jcopy.erase(j_checksum);
-    const auto vchksm = calculate_checksum(jcopy);
+    // calculate the checksum as if the checksum property was not there
+    const auto& chksm = jd[j_checksum].get_ref<const std::string&>();
+    const auto vchksm = hash_json(jd, j_checksum);
     return (chksm == vchksm);
 }
+
+//  Selective JSON loading
+//------------------------------------------------------------------------------
+//  SAX handler which builds only the selected sections (JSON pointers) of the document
+//  and optionally serializes the whole document (without the top level checksum) into
+//  the hash in the same pass.
+class SectionSax : public nlohmann::json_sax<json>
+{
+  public:
+    SectionSax(json& result, const std::vector<std::string>& sections,
+               std::shared_ptr<BufferedOutputAdapter> out)
+        : m_result(result)
+        , m_sections(sections)
+        , m_out(std::move(out))
+    {
+        if (m_out) {
+            m_ser = std::make_unique<nlohmann::detail::serializer<json>>(m_out, ' ');
+        }
+    }
+
+    //  Return the checksum stored in the document (empty if there is none).
+    const std::string& get_checksum() const
+    {
+        return m_checksum;
+    }
+
+    bool null() override
+    {
+        return put_value(json(nullptr));
+    }
+    bool boolean(bool val) override
+    {
+        return put_value(json(val));
+    }
+    bool number_integer(number_integer_t val) override
+    {
+        return put_value(json(val));
+    }
+    bool number_unsigned(number_unsigned_t val) override
+    {
+        return put_value(json(val));
+    }
+    bool number_float(number_float_t val, const string_t&) override
+    {
+        return put_value(json(val));
+    }
+    bool string(string_t& val) override
+    {
+        if (m_checksum_next) {
+            m_checksum = val;
+        }
+        return put_value(json(std::move(val)));
+    }
+    bool binary(binary_t&) override
+    {
+        // not produced by JSON text parser
+        return false;
+    }
+
+    bool start_object(std::size_t) override
+    {
+        begin_container(json::object(), '{');
+        return true;
+    }
+    bool key(string_t& val) override
+    {
+        auto& frame = m_stack.back();
+        if (m_stack.size() == 1 && val == j_checksum) {
+            // top level checksum is not part of the hashed data
+            m_checksum_next = true;
+        } else if (hashing()) {
+            if (!frame.first) {
+                m_out->write_character(',');
+            }
+            frame.first = false;
+            m_ser->dump(json(val), false, false, 0);
+            m_out->write_character(':');
+        }
+        if (frame.role != Role::skip) {
+            frame.key = std::move(val);
+        }
+        return true;
+    }
+    bool end_object() override
+    {
+        end_container('}');
+        return true;
+    }
+    bool start_array(std::size_t) override
+    {
+        begin_container(json::array(), '[');
+        return true;
+    }
+    bool end_array() override
+    {
+        end_container(']');
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&,
+                     const nlohmann::detail::exception& ex) override
+    {
+        throw hmdq_error(ex.what());
+    }
+
+  private:
+    //  How the value (or container) is processed
+    enum class Role {
+        skip, // not needed
+        prefix, // on the path to some section
+        select, // the value is the section or inside one
+    };
+
+    //  Opened container
+    struct Frame {
+        Role role;
+        json* node; // the built container (if not skipped)
+        bool array;
+        bool first = true; // no element serialized yet
+        size_t index = 0; // array index of the next element
+        std::string key; // object key of the next element
+        std::string ptr; // JSON pointer (only for prefix containers)
+    };
+
+    bool hashing() const
+    {
+        return m_ser && !m_checksum_next && !m_hash_off;
+    }
+
+    //  Escape the reference token for JSON pointer.
+    static std::string escape_token(const std::string& token)
+    {
+        std::string res;
+        res.reserve(token.size());
+        for (const char c : token) {
+            if (c == '~') {
+                res += "~0";
+            } else if (c == '/') {
+                res += "~1";
+            } else {
+                res += c;
+            }
+        }
+        return res;
+    }
+
+    //  Return the role of the value at `ptr` (a prefix container)
+    Role classify(const std::string& ptr) const
+    {
+        Role role = Role::skip;
+        for (const auto& sect : m_sections) {
+            if (sect == ptr) {
+                return Role::select;
+            }
+            if (sect.size() > ptr.size() && sect.compare(0, ptr.size(), ptr) == 0
+                && sect[ptr.size()] == '/') {
+                role = Role::prefix;
+            }
+        }
+        return role;
+    }
+
+    //  Resolve the role of the new value, write the separator into the hash and return
+    //  the JSON pointer of the value (only if it is needed).
+    Role begin_value(std::string& ptr)
+    {
+        if (m_checksum_next) {
+            // the value of the top level checksum
+            m_checksum_next = false;
+            m_hash_off = true;
+        }
+        if (m_stack.empty()) {
+            return classify(ptr);
+        }
+        auto& parent = m_stack.back();
+        std::string token;
+        if (parent.array) {
+            if (hashing() && !parent.first) {
+                m_out->write_character(',');
+            }
+            parent.first = false;
+            if (parent.role == Role::prefix) {
+                token = std::to_string(parent.index);
+            }
+            ++parent.index;
+        } else if (parent.role == Role::prefix) {
+            token = escape_token(parent.key);
+        }
+        if (parent.role != Role::prefix) {
+            return parent.role;
+        }
+        ptr = parent.ptr + '/' + token;
+        return classify(ptr);
+    }
+
+    //  Put the value into the result (if selected) and return a pointer to it.
+    json* store(Role role, const std::string& ptr, json&& val)
+    {
+        if (role == Role::skip) {
+            return nullptr;
+        }
+        if (m_stack.empty() || m_stack.back().role == Role::prefix) {
+            // top of a section (or a prefix container)
+            json& node = m_result[json::json_pointer(ptr)];
+            if (role == Role::select || node.is_null()) {
+                node = std::move(val);
+            }
+            return &node;
+        }
+        json& parent = *m_stack.back().node;
+        if (parent.is_array()) {
+            parent.push_back(std::move(val));
+            return &parent.back();
+        }
+        json& node = parent[m_stack.back().key];
+        node = std::move(val);
+        return &node;
+    }
+
+    bool put_value(json&& val)
+    {
+        std::string ptr;
+        const auto role = begin_value(ptr);
+        if (hashing()) {
+            m_ser->dump(val, false, false, 0);
+        }
+        // scalar values cannot be prefixes
+        store(role == Role::prefix ? Role::skip : role, ptr, std::move(val));
+        if (m_stack.size() <= 1) {
+            m_hash_off = false;
+        }
+        return true;
+    }
+
+    void begin_container(json&& empty, char open)
+    {
+        std::string ptr;
+        const auto role = begin_value(ptr);
+        if (hashing()) {
+            m_out->write_character(open);
+        }
+        json* node = store(role, ptr, std::move(empty));
+        m_stack.push_back({role, node, open == '['});
+        if (role == Role::prefix) {
+            m_stack.back().ptr = std::move(ptr);
+        }
+    }
+
+    void end_container(char close)
+    {
+        if (hashing()) {
+            m_out->write_character(close);
+        }
+        m_stack.pop_back();
+        if (m_stack.size() <= 1) {
+            m_hash_off = false;
+        }
+    }
+
+  private:
+    json& m_result;
+    const std::vector<std::string>& m_sections;
+    std::shared_ptr<BufferedOutputAdapter> m_out;
+    std::unique_ptr<nlohmann::detail::serializer<json>> m_ser;
+    std::vector<Frame> m_stack;
+    std::string m_checksum;
+    bool m_checksum_next = false; // the next value is the top level checksum
+    bool m_hash_off = false; // inside the top level checksum value
+};
+
+//  Read and parse only the selected sections of JSON file.
+json read_json_sections(const std::filesystem::path& inpath,
+                        const std::vector<std::string>& sections, bool* check_ok)
+{
+    json res;
+    std::unique_ptr<Botan::HashFunction> b2b;
+    std::shared_ptr<BufferedOutputAdapter> out;
+    if (nullptr != check_ok) {
+        b2b = create_checksum_hash();
+        out = make_hash_adapter(*b2b);
+    }
+
+    SectionSax sax(res, sections, out);
+    parse_file(inpath, [&](const char* first, const char* last) {
+        sax_parse_data(first, last, sax);
+        if (nullptr != check_ok) {
+            out->flush();
+            const auto& chksm = sax.get_checksum();
+            *check_ok = !chksm.empty() && chksm == Botan::hex_encode(b2b->final());
+        }
+        return true;
+    });
+    return res;
+}
@@ -17,6 +17,7 @@
 
 #include <filesystem>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 //  globals
@@ -27,13 +28,45 @@ constexpr int CHKSUM_BITSIZE = 128;
 //  Anonymizing pre-defs
 constexpr auto ANON_BITSIZE = 96;
 
+//  typedefs
+//------------------------------------------------------------------------------
+//  Data file formats. The binary formats store float vectors and matrices as typed
+//  arrays, the checksum is always calculated over the (same) JSON document.
+enum class jformat { json, cbor, msgpack };
+
 //  JSON file I/O
 //------------------------------------------------------------------------------
-//  Extract relevant data from OpenVR API
+//  Read and parse JSON file, return json data. The file is memory mapped (or read in
+//  one go if it cannot be mapped) and parsed from the contiguous buffer. The binary
+//  formats (CBOR, MessagePack) are detected automatically. The path can also address
+//  one entry in the archive ("<archive>#<selector>", see `Archive::select`).
 json read_json(const std::filesystem::path& inpath);
 
-// Save JSON data into file with indentation.
-void write_json(const std::filesystem::path& outpath, const json& jdata, int indent);
+//  Return the raw content of the data file (or the archive entry).
+std::vector<char> read_data(const std::filesystem::path& inpath);
+
+//  Parse JSON file with a custom SAX handler (the file is read the same way as in
+//  `read_json`). Return the result of the SAX parser.
+bool sax_parse_json(const std::filesystem::path& inpath, nlohmann::json_sax<json>& sax);
+
+//  Read and parse only the selected sections of JSON file. The sections are given as
+//  JSON pointers (e.g. "/misc" or "/openvr/geometry"), the rest of the file is parsed,
+//  but not stored. If `check_ok` is not null, the checksum of the whole file is
+//  verified in the same pass (as `verify_checksum` does) and the result is stored
+//  there.
+json read_json_sections(const std::filesystem::path& inpath,
+                        const std::vector<std::string>& sections,
+                        bool* check_ok = nullptr);
+
+// Save JSON data into file with indentation (or in the binary format). The data are
+// serialized directly into the file, if `with_checksum` is true, the checksum is
+// calculated in the same pass and written as the last property (replacing the one in
+// `jdata`, if any).
+void write_json(const std::filesystem::path& outpath, const json& jdata, int indent,
+                jformat format = jformat::json, bool with_checksum = false);
+
+//  Return the data format for its name ("json", "cbor", "msgpack").
+jformat get_jformat(const std::string& name);
 
 //  JSON data manipulation
 //------------------------------------------------------------------------------
@@ -77,7 +110,7 @@ inline json make_error_obj(const std::string& msg)
 void anonymize(std::vector<char>& out, const std::vector<char>& in);
 
 //  Anonymize properties in JSON list
-void anonymize_jdprops(json& jdprops, const std::vector<std::string>& anon_prop_names,
+void anonymize_jdprops(json& jdprops, const std::unordered_set<std::string>& anon_props,
                        const std::vector<std::string>& seed_prop_names);
 
 //  Checksum functions
@@ -19,6 +19,7 @@
 #include <common/oculus_processor.h>
 #include <common/oculus_props.h>
 #include <common/prtdata.h>
+#include <common/tpool.h>
 #include <common/xtdef.h>
 
 #include <Extras/OVR_Math.h>
@@ -33,6 +34,8 @@
 #include <fmt/ranges.h>
 
 #include <filesystem>
+#include <future>
+#include <vector>
 
 namespace oculus {
 
@@ -70,7 +73,7 @@ std::vector<std::string> get_controller_names(int val)
 void print_oculus(const json& jd, int verb, int ind, int ts)
 {
     const auto sf = ind * ts;
-    const auto vdef = g_cfg[j_verbosity][j_default].get<int>();
+    const auto vdef = g_cfgs.verb.def;
     if (verb >= vdef) {
         iprint(sf, "Oculus runtime version: {:s}\n", jd[j_rt_ver].get<std::string>());
     }
@@ -93,13 +96,13 @@ void print_devs(const json& devs, int ind, int ts)
 }
 
 //  Print device properties.
-void print_dev_props(const json& dprops, int verb, int ind, int ts)
+void print_dev_props(basevr::PropIndex& pindex, const json& dprops, int verb, int ind,
+                     int ts)
 {
-    const auto verb_props = g_cfg[j_oculus][j_verbosity][j_properties];
-
     int propId = 1;
     for (const auto& [pname, pval] : dprops.items()) {
-        basevr::print_one_prop(pname, pval, propId++, verb_props, verb, ind, ts);
+        const auto& pdesc = pindex.add(pname);
+        basevr::print_one_prop(pdesc, pval, propId++, verb, ind, ts);
     }
 }
 
@@ -107,13 +110,15 @@ void print_dev_props(const json& dprops, int verb, int ind, int ts)
 void print_all_props(const json& props, int verb, int ind, int ts)
 {
     const auto sf = ind * ts;
-    const auto vdef = g_cfg[j_verbosity][j_default].get<int>();
+    const auto vdef = g_cfgs.verb.def;
+    // Oculus properties are not defined upfront, the index is built while printing
+    basevr::PropIndex pindex(g_cfgs.oculus.verb_props, g_cfgs.verb.max);
 
     for (const auto& [sdev, dprops] : props.items()) {
         if (verb >= vdef) {
             iprint(sf, "[{:s}]\n", sdev);
         }
-        print_dev_props(dprops, verb, ind + 1, ts);
+        print_dev_props(pindex, dprops, verb, ind + 1, ts);
     }
 }
 
@@ -135,6 +140,18 @@ void precalc_geometry(json& jd)
     jd[j_eye2head] = eye2head;
 }
 
+//  Calculate one FOV geometry (with the eyes as separate tasks if the pool is given).
+static void calc_fov_geometry(json& fov_geom, ThreadPool* pool, size_t profile)
+{
+    if (geometry_sanity_check(fov_geom)) {
+        precalc_geometry(fov_geom);
+        fov_geom = pool ? calc_geometry(fov_geom, *pool, profile)
+                        : calc_geometry(fov_geom, profile);
+    } else {
+        add_error(fov_geom, "Geometry data are invalid (check JSON output file)");
+    }
+}
+
 //  OculusVR Processor class
 //------------------------------------------------------------------------------
 // Initialize the processor
@@ -144,18 +161,28 @@ bool Processor::init()
 }
 
 // Calculate the complementary data
-void Processor::calculate()
+void Processor::calculate(size_t profile)
 {
     if (m_pjData->find(j_geometry) != m_pjData->end()) {
-        auto& geom = (*m_pjData)[j_geometry];
-        for (auto& [fovType, fovGeom] : geom.items()) {
-            if (geometry_sanity_check(fovGeom)) {
-                precalc_geometry(fovGeom);
-                geom[fovType] = calc_geometry(fovGeom);
-            } else {
-                add_error(fovGeom, "Geometry data are invalid (check JSON output file)");
-            }
+        for (auto& [fovType, fovGeom] : (*m_pjData)[j_geometry].items()) {
+            calc_fov_geometry(fovGeom, nullptr, profile);
+        }
+    }
+}
+
+// Calculate the complementary data (each FOV geometry and each eye as a separate task)
+void Processor::calculate(ThreadPool& pool, size_t profile)
+{
+    if (m_pjData->find(j_geometry) != m_pjData->end()) {
+        std::vector<std::future<void>> tasks;
+        for (auto& [fovType, fovGeom] : (*m_pjData)[j_geometry].items()) {
+            json* pgeom = &fovGeom;
+            tasks.push_back(
+                pool.submit([pgeom, &pool, profile]() {
+                    calc_fov_geometry(*pgeom, &pool, profile);
+                }));
         }
+        pool.wait_all(tasks);
     }
 }
 
@@ -163,10 +190,8 @@ void Processor::calculate()
 void Processor::anonymize()
 {
     if (m_pjData->find(j_properties) != m_pjData->end()) {
-        const std::vector<std::string> anon_props_names
-            = g_cfg[j_oculus][j_anonymize][j_properties].get<std::vector<std::string>>();
         for (auto& [sdev, jdprops] : (*m_pjData)[j_properties].items()) {
-            anonymize_jdprops(jdprops, anon_props_names, PROPS_TO_SEED);
+            anonymize_jdprops(jdprops, g_cfgs.oculus.anon_props, PROPS_TO_SEED);
         }
     }
 }
@@ -178,8 +203,8 @@ void Processor::anonymize()
 // ts: indent (tab) size
 void Processor::print(const print_options& opts, int ind, int ts) const
 {
-    const auto vdef = g_cfg[j_verbosity][j_default].get<int>();
-    const auto vsil = g_cfg[j_verbosity][j_silent].get<int>();
+    const auto vdef = g_cfgs.verb.def;
+    const auto vsil = g_cfgs.verb.silent;
 
     // if there was an error and there are no data, print the error and quit
     if (has_error(*m_pjData)) {
@@ -191,7 +216,7 @@ void Processor::print(const print_options& opts, int ind, int ts) const
 
     print_oculus(*m_pjData, opts.verbosity, ind, ts);
     if (opts.verbosity >= vdef)
-        fmt::print("\n");
+        oprint("\n");
 
     // print the devices and the properties
     auto tverb
@@ -199,11 +224,11 @@ void Processor::print(const print_options& opts, int ind, int ts) const
     if (tverb >= vdef) {
         if (m_pjData->find(j_devices) != m_pjData->end()) {
             print_devs((*m_pjData)[j_devices], ind, ts);
-            fmt::print("\n");
+            oprint("\n");
         }
         if (m_pjData->find(j_properties) != m_pjData->end()) {
             print_all_props((*m_pjData)[j_properties], tverb, ind, ts);
-            fmt::print("\n");
+            oprint("\n");
         }
     }
 
@@ -220,12 +245,12 @@ void Processor::print(const print_options& opts, int ind, int ts) const
                     //  print the new line in between the different FOVs, but not before
                     //  (or after)
                     if (print_nl) {
-                        fmt::print("\n");
+                        oprint("\n");
                     } else {
                         print_nl = true;
                     }
                     iprint(sf, "{}:\n", get_jkey_pretty(fovType));
-                    fmt::print("\n");
+                    oprint("\n");
                     if (has_error(fovGeom)) {
                         iprint((ind + 1) * ts, ERR_MSG_FMT_OUT, get_error_msg(fovGeom));
                     } else {
@@ -33,7 +33,9 @@ class Processor : public BaseVRProcessor
     // Initialize the processor
     virtual bool init() override;
     // Calculate complementary data
-    virtual void calculate() override;
+    virtual void calculate(size_t profile) override;
+    // Calculate complementary data, the independent parts run as tasks in the pool
+    virtual void calculate(ThreadPool& pool, size_t profile) override;
     // Anonymize sensitive data
     virtual void anonymize() override;
     // Print the collected data
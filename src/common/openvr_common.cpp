@@ -9,11 +9,22 @@
  * SPDX-License-Identifier: BSD-3-Clause                                      *
  ******************************************************************************/
 
+#include <common/config.h>
 #include <common/jkeys.h>
+#include <common/jtools.h>
 #include <common/openvr_common.h>
 
+#include <openvr_api_table.h>
+
 #include <openvr/openvr.h>
 
+#include <algorithm>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 namespace openvr {
 
 //  globals
@@ -61,6 +72,116 @@ json parse_json_oapi(const json& jd)
     return json({{j_classes, tdcls}, {j_properties, tdprops}});
 }
 
+//  Build OpenVR API definition from the built-in table (generated from
+//  "openvr_api.json" at build time), the result is the same as from `parse_json_oapi`.
+json make_json_oapi()
+{
+    // The generated table has unique ids and names, so the keys are pushed back
+    // directly (`emplace` and `operator[]` of ordered_json search all the keys before
+    // inserting).
+    // categories in the order of appearance
+    std::vector<std::pair<int, json::object_t>> cats;
+    json::object_t name2id;
+    name2id.reserve(OAPI_PROPS.size());
+    size_t icat = 0;
+    for (const auto& prop : OAPI_PROPS) {
+        if (cats.empty() || cats[icat].first != prop.cat) {
+            const auto it
+                = std::find_if(cats.cbegin(), cats.cend(),
+                               [&prop](const auto& c) { return c.first == prop.cat; });
+            icat = it - cats.cbegin();
+            if (it == cats.cend()) {
+                cats.emplace_back(prop.cat, json::object_t());
+            }
+        }
+        cats[icat].second.push_back({std::to_string(prop.id), prop.name});
+        name2id.push_back({prop.name, prop.id});
+    }
+    // the same key order as from `parse_json_oapi`, the names follow the first category
+    json tdprops;
+    if (!cats.empty()) {
+        json::object_t props;
+        props.reserve(cats.size() + 1);
+        for (auto& [cat, cat_props] : cats) {
+            props.push_back({std::to_string(cat), std::move(cat_props)});
+            if (props.size() == 1) {
+                props.push_back({j_name2id, std::move(name2id)});
+            }
+        }
+        tdprops = std::move(props);
+    }
+    json::object_t tdcls;
+    tdcls.reserve(OAPI_CLASSES.size());
+    for (const auto& cls : OAPI_CLASSES) {
+        tdcls.push_back({std::to_string(cls.id), cls.name});
+    }
+    return json({{j_classes, std::move(tdcls)}, {j_properties, std::move(tdprops)}});
+}
+
+//  Load OpenVR API definition from the file, or from the built-in table if the path is
+//  empty.
+json load_json_oapi(const std::filesystem::path& api_path)
+{
+    if (api_path.empty()) {
+        return make_json_oapi();
+    }
+    return parse_json_oapi(read_json(api_path));
+}
+
+//  Build the property index over OpenVR API definition. The properties known from the
+//  built-in table take the descriptors from there, only the others (e.g. from a newer
+//  API file) have their names parsed.
+static std::shared_ptr<const basevr::PropIndex> make_prop_index(const json& api)
+{
+    static const auto s_table = []() {
+        std::unordered_map<std::string_view, const OapiProp*> res;
+        res.reserve(OAPI_PROPS.size());
+        for (const auto& prop : OAPI_PROPS) {
+            res.emplace(prop.name, &prop);
+        }
+        return res;
+    }();
+
+    auto pindex
+        = std::make_shared<basevr::PropIndex>(g_cfgs.openvr.verb_props, g_cfgs.verb.max);
+    for (const auto& [pname, jpid] : api[j_properties][j_name2id].items()) {
+        const auto pid = jpid.get<int>();
+        const auto it = s_table.find(pname);
+        if (it != s_table.end() && it->second->id == pid) {
+            const OapiProp& prop = *it->second;
+            basevr::PropDesc pdesc;
+            pdesc.name = prop.name;
+            pdesc.pid = prop.id;
+            pdesc.basename = prop.basename;
+            pdesc.type_name = prop.type_name;
+            pdesc.ptype = prop.type;
+            pdesc.is_array = prop.is_array;
+            pindex->add(std::move(pdesc));
+        } else {
+            pindex->add(pname, pid);
+        }
+    }
+    return pindex;
+}
+
+//  Return the property index over OpenVR API definition (with the verbosity levels from
+//  the config). The index is built only once for the same `pjapi`.
+std::shared_ptr<const basevr::PropIndex>
+get_prop_index(const std::shared_ptr<json>& pjapi)
+{
+    static std::mutex mtx;
+    // keep the API definition alive, so the pointer cannot be reused
+    static std::shared_ptr<json> s_pjapi;
+    static std::shared_ptr<const basevr::PropIndex> s_pindex;
+
+    std::lock_guard lock(mtx);
+    if (s_pjapi != pjapi) {
+        s_pindex = make_prop_index(*pjapi);
+        s_pjapi = pjapi;
+    }
+    return s_pindex;
+}
+
 //  Convert common property types to OpenVR property types
 vr::PropertyTypeTag_t ptype_to_ptag(basevr::PropType ptype)
 {
@@ -16,6 +16,8 @@
 
 #include <openvr/openvr.h>
 
+#include <filesystem>
+#include <memory>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -42,6 +44,19 @@ std::tuple<uint32_t, uint32_t, uint32_t> get_sdk_ver();
 //  Parse OpenVR JSON API definition, where jd = json.load("openvr_api.json")
 json parse_json_oapi(const json& jd);
 
+//  Build OpenVR API definition from the built-in table (generated from
+//  "openvr_api.json" at build time), the result is the same as from `parse_json_oapi`.
+json make_json_oapi();
+
+//  Load OpenVR API definition from the file, or from the built-in table if the path is
+//  empty.
+json load_json_oapi(const std::filesystem::path& api_path);
+
+//  Return the property index over OpenVR API definition (with the verbosity levels from
+//  the config). The index is built only once for the same `pjapi`.
+std::shared_ptr<const basevr::PropIndex>
+get_prop_index(const std::shared_ptr<json>& pjapi);
+
 //  Convert common property types to OpenVR property types
 vr::PropertyTypeTag_t ptype_to_ptag(basevr::PropType ptype);
 
@@ -41,7 +41,7 @@ const std::vector<std::string> PROPS_TO_SEED
 void print_openvr(const json& jd, int verb, int ind, int ts)
 {
     const auto sf = ind * ts;
-    const auto vdef = g_cfg[j_verbosity][j_default].get<int>();
+    const auto vdef = g_cfgs.verb.def;
     if (verb >= vdef) {
         if (jd.contains(j_rt_path)) {
             iprint(sf, "OpenVR runtime path: {:s}\n", jd[j_rt_path].get<std::string>());
@@ -55,7 +55,7 @@ void print_openvr(const json& jd, int verb, int ind, int ts)
 //  Print enumerated devices.
 void print_devs(const json& api, const json& devs, int ind, int ts)
 {
-    const auto vdef = g_cfg[j_verbosity][j_default].get<int>();
+    const auto vdef = g_cfgs.verb.def;
     const auto sf = ind * ts;
     const auto sf1 = (ind + 1) * ts;
 
@@ -69,27 +69,25 @@ void print_devs(const json& api, const json& devs, int ind, int ts)
 }
 
 //  Print device properties.
-void print_dev_props(const json& api, const json& dprops, int verb, int ind, int ts)
+void print_dev_props(const basevr::PropIndex& pindex, const json& dprops, int verb,
+                     int ind, int ts)
 {
-    const auto verb_props = g_cfg[j_openvr][j_verbosity][j_properties];
-
     for (const auto& [pname, pval] : dprops.items()) {
-        const auto name2id = api[j_properties][j_name2id];
+        const auto pdesc = pindex.find(pname);
         // if there is a property which is no longer supported by current openvr_api.json
         // ignore it
-        if (name2id.contains(pname)) {
-            // convert string to the correct type
-            const auto pid = name2id[pname].get<int>();
-            basevr::print_one_prop(pname, pval, pid, verb_props, verb, ind, ts);
+        if (pdesc) {
+            basevr::print_one_prop(*pdesc, pval, pdesc->pid, verb, ind, ts);
         }
     }
 }
 
 //  Print all properties for all devices.
-void print_all_props(const json& api, const json& props, int verb, int ind, int ts)
+void print_all_props(const json& api, const basevr::PropIndex& pindex, const json& props,
+                     int verb, int ind, int ts)
 {
     const auto sf = ind * ts;
-    const auto vdef = g_cfg[j_verbosity][j_default].get<int>();
+    const auto vdef = g_cfgs.verb.def;
 
     for (const auto& [sdid, dprops] : props.items()) {
         const auto dclass
@@ -98,7 +96,7 @@ void print_all_props(const json& api, const json& props, int verb, int ind, int
         if (verb >= vdef) {
             iprint(sf, "[{:s}:{:s}]\n", sdid, dcname);
         }
-        print_dev_props(api, dprops, verb, ind + 1, ts);
+        print_dev_props(pindex, dprops, verb, ind + 1, ts);
     }
 }
 
@@ -108,18 +106,27 @@ void print_all_props(const json& api, const json& props, int verb, int ind, int
 bool Processor::init()
 {
     if (!m_pjApi) {
-        json oapi = read_json(m_apiPath);
-        m_pjApi = std::make_shared<json>(openvr::parse_json_oapi(oapi));
+        m_pjApi = std::make_shared<json>(openvr::load_json_oapi(m_apiPath));
     }
+    m_pPropIndex = get_prop_index(m_pjApi);
 
     return true;
 }
 
 // Calculate the complementary data
-void Processor::calculate()
+void Processor::calculate(size_t profile)
+{
+    if (m_pjData->find(j_geometry) != m_pjData->end()) {
+        (*m_pjData)[j_geometry] = calc_geometry((*m_pjData)[j_geometry], profile);
+    }
+}
+
+// Calculate the complementary data (each eye as a separate task)
+void Processor::calculate(ThreadPool& pool, size_t profile)
 {
     if (m_pjData->find(j_geometry) != m_pjData->end()) {
-        (*m_pjData)[j_geometry] = calc_geometry((*m_pjData)[j_geometry]);
+        (*m_pjData)[j_geometry]
+            = calc_geometry((*m_pjData)[j_geometry], pool, profile);
     }
 }
 
@@ -127,10 +134,8 @@ void Processor::calculate()
 void Processor::anonymize()
 {
     if (m_pjData->find(j_properties) != m_pjData->end()) {
-        const std::vector<std::string> anon_props_names
-            = g_cfg[j_openvr][j_anonymize][j_properties].get<std::vector<std::string>>();
         for (auto& [sdid, jdprops] : (*m_pjData)[j_properties].items()) {
-            anonymize_jdprops(jdprops, anon_props_names, PROPS_TO_SEED);
+            anonymize_jdprops(jdprops, g_cfgs.openvr.anon_props, PROPS_TO_SEED);
         }
     }
 }
@@ -142,8 +147,8 @@ void Processor::anonymize()
 // ts: indent (tab) size
 void Processor::print(const print_options& opts, int ind, int ts) const
 {
-    const auto vdef = g_cfg[j_verbosity][j_default].get<int>();
-    const auto vsil = g_cfg[j_verbosity][j_silent].get<int>();
+    const auto vdef = g_cfgs.verb.def;
+    const auto vsil = g_cfgs.verb.silent;
 
     // if there was an error and there are no data, print the error and quit
     if (has_error(*m_pjData)) {
@@ -156,7 +161,7 @@ void Processor::print(const print_options& opts, int ind, int ts) const
 
     print_openvr((*m_pjData), opts.verbosity, ind, ts);
     if (opts.verbosity >= vdef)
-        fmt::print("\n");
+        oprint("\n");
 
     // print the devices and the properties
     auto tverb
@@ -164,11 +169,12 @@ void Processor::print(const print_options& opts, int ind, int ts) const
     if (tverb >= vdef) {
         if (m_pjData->contains(j_devices)) {
             print_devs(*m_pjApi, (*m_pjData)[j_devices], ind, ts);
-            fmt::print("\n");
+            oprint("\n");
         }
         if (m_pjData->contains(j_properties)) {
-            print_all_props(*m_pjApi, (*m_pjData)[j_properties], tverb, ind, ts);
-            fmt::print("\n");
+            print_all_props(*m_pjApi, *m_pPropIndex, (*m_pjData)[j_properties], tverb,
+                            ind, ts);
+            oprint("\n");
         }
     }
 
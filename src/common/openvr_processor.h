@@ -12,10 +12,12 @@
 #pragma once
 
 #include <common/base_classes.h>
+#include <common/base_common.h>
 #include <common/jkeys.h>
 #include <common/json_proxy.h>
 
 #include <filesystem>
+#include <memory>
 #include <string>
 
 namespace openvr {
@@ -39,7 +41,9 @@ class Processor : public BaseVRProcessor
     // Initialize the processor
     virtual bool init() override;
     // Calculate complementary data
-    virtual void calculate() override;
+    virtual void calculate(size_t profile) override;
+    // Calculate complementary data, the independent parts run as tasks in the pool
+    virtual void calculate(ThreadPool& pool, size_t profile) override;
     // Anonymize sensitive data
     virtual void anonymize() override;
     // Print the collected data
@@ -56,6 +60,8 @@ class Processor : public BaseVRProcessor
     std::filesystem::path m_apiPath;
     // API extract
     std::shared_ptr<json> m_pjApi;
+    // Property descriptor index (over API extract)
+    std::shared_ptr<const basevr::PropIndex> m_pPropIndex;
 };
 
 } // namespace openvr
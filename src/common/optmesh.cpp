@@ -15,8 +15,12 @@
 
 #include <xtensor/xview.hpp>
 
-#include <list>
+#include <algorithm>
+#include <bit>
+#include <cmath>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 //  functions
 //------------------------------------------------------------------------------
@@ -38,39 +42,115 @@ long long v_in_verts(const hvector_t& v, const hveclist_t& verts)
     return -1;
 }
 
+//  Hash the vertex (row) `i` in `verts` by its values. Negative zero is hashed as
+//  positive zero so the hash is consistent with the value comparison below.
+struct VertRowHash {
+    const harray2d_t* verts;
+
+    size_t operator()(size_t i) const
+    {
+        size_t res = 0;
+        for (size_t j = 0, e = verts->shape(1); j < e; ++j) {
+            const auto bits = std::bit_cast<uint64_t>((*verts)(i, j) + 0.0);
+            res ^= std::hash<uint64_t>{}(bits) + 0x9e3779b97f4a7c15ull + (res << 6)
+                + (res >> 2);
+        }
+        return res;
+    }
+};
+
+//  Compare the vertices (rows) `i1` and `i2` in `verts` by their values.
+struct VertRowEqual {
+    const harray2d_t* verts;
+
+    bool operator()(size_t i1, size_t i2) const
+    {
+        for (size_t j = 0, e = verts->shape(1); j < e; ++j) {
+            if ((*verts)(i1, j) != (*verts)(i2, j)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+//  Return true if any coordinate of the vertex (row) `i` in `verts` is NaN.
+inline bool vert_has_nan(const harray2d_t& verts, size_t i)
+{
+    for (size_t j = 0, e = verts.shape(1); j < e; ++j) {
+        if (std::isnan(verts(i, j))) {
+            return true;
+        }
+    }
+    return false;
+}
+
 //  Remove duplicate vertices in `verts` and rearrange `faces`.
-std::pair<harray2d_t, hfaces_t> reduce_verts(const harray2d_t& verts,
-                                             const hfaces_t& faces)
+//  The vertices are welded through a hash index (original vertex index -> new vertex
+//  index), which gives the same result as testing each vertex with `v_in_verts`.
+std::pair<harray2d_t, hcfaces_t> reduce_verts(const harray2d_t& verts,
+                                              const hcfaces_t& faces)
 {
-    hveclist_t r_verts;
-    hfaces_t r_faces;
-    for (const auto& f : faces) {
-        hface_t new_f;
-        for (const auto v_i : f) {
-            auto i = v_in_verts(xt::view(verts, v_i), r_verts);
-            if (i >= 0) {
-                new_f.push_back(i);
-            } else {
-                r_verts.push_back(xt::view(verts, v_i));
-                new_f.push_back(r_verts.size() - 1);
-            }
+    const size_t ncorners = faces.indices.size();
+    std::unordered_map<size_t, hindex_t, VertRowHash, VertRowEqual> windex(
+        ncorners, VertRowHash{&verts}, VertRowEqual{&verts});
+    // original indices of the welded vertices
+    std::vector<size_t> r_idx;
+    hcfaces_t r_faces;
+    r_faces.reserve(faces.size(), ncorners);
+    for (const auto v_i : faces.indices) {
+        // NaN never compares equal, so such a vertex is always a new one
+        if (vert_has_nan(verts, v_i)) {
+            r_faces.indices.push_back(static_cast<hindex_t>(r_idx.size()));
+            r_idx.push_back(v_i);
+            continue;
         }
-        r_faces.push_back(new_f);
+        const auto [it, inserted]
+            = windex.try_emplace(v_i, static_cast<hindex_t>(r_idx.size()));
+        if (inserted) {
+            r_idx.push_back(v_i);
+        }
+        r_faces.indices.push_back(it->second);
     }
+    // the faces topology does not change, only the vertex indices do
+    r_faces.offsets = faces.offsets;
     // build the new verts
-    return std::make_pair(build_array(r_verts), r_faces);
+    // at least one vertex should always be present
+    HMDQ_ASSERT(r_idx.size() > 0);
+    const size_t ncols = verts.shape(1);
+    harray2d_t r_verts({r_idx.size(), ncols});
+    for (size_t i = 0, e = r_idx.size(); i < e; ++i) {
+        for (size_t j = 0; j < ncols; ++j) {
+            r_verts(i, j) = verts(r_idx[i], j);
+        }
+    }
+    return std::make_pair(r_verts, r_faces);
 }
 
-//  Return edges in the face.
-hedgelist_t face2edges(const hface_t& face)
+//  Return edges in the face (for any random access container).
+template <typename Face>
+hedgelist_t face2edges_any(const Face& face)
 {
     hedgelist_t res;
+    res.reserve(face.size());
     for (size_t i = 0, e = face.size(); i < e; ++i) {
         res.push_back({face[i], face[(i + 1) % e]});
     }
     return res;
 }
 
+//  Return edges in the face.
+hedgelist_t face2edges(const hface_t& face)
+{
+    return face2edges_any(face);
+}
+
+//  Return edges in the face (compressed face list item).
+hedgelist_t face2edges(std::span<const hindex_t> face)
+{
+    return face2edges_any(face);
+}
+
 //  Sort edges orientation, so the first vertex has lower index.
 hedgelist_t sort_edges(const hedgelist_t& edges)
 {
@@ -260,49 +340,173 @@ bool has_cycle(const hface_t& face)
     return false;
 }
 
+//  Hash an edge for the edge index.
+struct EdgeHash {
+    size_t operator()(const hedge_t& e) const
+    {
+        const auto h1 = std::hash<size_t>{}(e.first);
+        const auto h2 = std::hash<size_t>{}(e.second);
+        return h1 ^ (h2 + 0x9e3779b97f4a7c15ull + (h1 << 6) + (h1 >> 2));
+    }
+};
+
+//  Undirected edge (sorted) -> faces the edge belongs to.
+typedef std::unordered_map<hedge_t, std::vector<size_t>, EdgeHash> hedgeindex_t;
+//  Undirected edge (sorted) -> number of its occurrences in the face.
+typedef std::unordered_map<hedge_t, size_t, EdgeHash> hedgecount_t;
+
+//  Sort edge orientation, so the first vertex has lower index.
+inline hedge_t sort_edge(const hedge_t& e)
+{
+    return (e.first <= e.second) ? e : hedge_t{e.second, e.first};
+}
+
+//  Count the undirected edges in the edge list.
+hedgecount_t count_edges(const hedgelist_t& edges)
+{
+    hedgecount_t res;
+    for (const auto& e : edges) {
+        ++res[sort_edge(e)];
+    }
+    return res;
+}
+
+//  Update the edge counts of the face merged with the face `edges2` over the shared
+//  `chain`, i.e. remove the chain edges and add the remaining edges of `edges2`.
+void merge_edge_counts(hedgecount_t& counts1, const hedgelist_t& edges2,
+                       const hedgelist_t& chain)
+{
+    hedgecount_t chain_counts = count_edges(chain);
+    for (const auto& [edge, count] : chain_counts) {
+        const auto it = counts1.find(edge);
+        HMDQ_ASSERT(it != counts1.end() && it->second >= count);
+        it->second -= count;
+        if (0 == it->second) {
+            counts1.erase(it);
+        }
+    }
+    for (const auto& e : edges2) {
+        const auto se = sort_edge(e);
+        const auto it = chain_counts.find(se);
+        if (it != chain_counts.end() && it->second > 0) {
+            --it->second;
+        } else {
+            ++counts1[se];
+        }
+    }
+}
+
+//  Return shared edges, where the first edge list is given by its edge counts.
+//  The result is the same as from `shared_edges`.
+hedgelist_t shared_edges(const hedgecount_t& counts1, const hedgelist_t& edges2)
+{
+    hedgelist_t te2 = sort_edges(edges2);
+    std::sort(te2.begin(), te2.end());
+    hedgelist_t res;
+    for (size_t i = 0, e = te2.size(); i < e;) {
+        size_t j = i + 1;
+        while (j < e && te2[j] == te2[i]) {
+            ++j;
+        }
+        const auto it = counts1.find(te2[i]);
+        if (it != counts1.end()) {
+            res.insert(res.end(), std::min(it->second, j - i), te2[i]);
+        }
+        i = j;
+    }
+    return res;
+}
+
+//  Build the index of the undirected edges to the faces they belong to.
+hedgeindex_t build_edge_index(const hcfaces_t& faces)
+{
+    hedgeindex_t res;
+    for (size_t i = 0, e = faces.size(); i < e; ++i) {
+        for (const auto& edge : face2edges(faces[i])) {
+            auto& efaces = res[sort_edge(edge)];
+            if (efaces.empty() || efaces.back() != i) {
+                efaces.push_back(i);
+            }
+        }
+    }
+    return res;
+}
+
 // Reduce faces by removing duplicate edges.
-hfaces_t reduce_faces(const hfaces_t& faces)
+// The faces are merged in the same order as if each face was checked against all
+// remaining faces in a list (until no merge happens), but only the faces sharing an
+// edge with the merged face (found in the edge index) are actually visited.
+hcfaces_t reduce_faces(const hcfaces_t& faces)
 {
+    const size_t nfaces_in = faces.size();
+    const hedgeindex_t eindex = build_edge_index(faces);
+    // faces either already used as a seed or merged into one
+    std::vector<bool> used(nfaces_in, false);
+
+    // add the unused neighbours of the face `fi` to the candidates
+    const auto add_neighbours = [&](size_t fi, std::set<size_t>& cands) {
+        for (const auto& edge : face2edges(faces[fi])) {
+            for (const auto ni : eindex.at(sort_edge(edge))) {
+                if (!used[ni]) {
+                    cands.insert(ni);
+                }
+            }
+        }
+    };
+
     // result
-    hfaces_t nfaces;
-    // faces to process
-    std::list<hface_t> tfaces(faces.begin(), faces.end());
-
-    while (tfaces.size() >= 2) {
-        // run the loop until there are at least two faces to check
-        hface_t face = tfaces.front();
-        tfaces.pop_front();
+    hcfaces_t nfaces;
+    for (size_t seed = 0; seed < nfaces_in; ++seed) {
+        if (used[seed]) {
+            continue;
+        }
+        used[seed] = true;
+        hface_t face(faces[seed].begin(), faces[seed].end());
+        hedgelist_t edges1 = face2edges(face);
+        hedgecount_t counts1 = count_edges(edges1);
+        // neighbours of the merged face ordered by their position in the input
+        std::set<size_t> cands;
+        add_neighbours(seed, cands);
         bool found = true;
         while (found) {
-            hfaces_t checked;
             found = false;
-            while (tfaces.size()) {
-                hface_t f = tfaces.front();
-                tfaces.pop_front();
-                hedgelist_t edges1 = face2edges(face);
-                hedgelist_t edges2 = face2edges(f);
-                hedgelist_t shared = shared_edges(edges1, edges2);
-                if (shared.size()) {
-                    auto chain = check_chained(shared);
-                    if (0 != chain.size()) {
-                        auto new_face = merge_edges(edges1, edges2, chain);
-                        if (!has_cycle(new_face)) {
-                            face = new_face;
-                            found = true;
-                        } else {
-                            checked.push_back(f);
-                        }
-                    } else {
-                        checked.push_back(f);
+            // neighbours which could not be merged in this pass
+            std::vector<size_t> checked;
+            // position of the last visited face in the input
+            size_t pos = seed;
+            for (auto it = cands.upper_bound(pos); it != cands.end();
+                 it = cands.upper_bound(pos)) {
+                const size_t fi = *it;
+                cands.erase(it);
+                pos = fi;
+                if (used[fi]) {
+                    continue;
+                }
+                const hedgelist_t edges2 = face2edges(faces[fi]);
+                const hedgelist_t shared = shared_edges(counts1, edges2);
+                if (shared.empty()) {
+                    // no longer a neighbour, it gets back if one of the merged faces
+                    // shares an edge with it again
+                    continue;
+                }
+                const auto chain = check_chained(shared);
+                if (0 != chain.size()) {
+                    auto new_face = merge_edges(edges1, edges2, chain);
+                    if (!has_cycle(new_face)) {
+                        face = std::move(new_face);
+                        edges1 = face2edges(face);
+                        merge_edge_counts(counts1, edges2, chain);
+                        used[fi] = true;
+                        add_neighbours(fi, cands);
+                        found = true;
+                        continue;
                     }
-                } else {
-                    checked.push_back(f);
                 }
+                checked.push_back(fi);
             }
-            tfaces.assign(checked.begin(), checked.end());
+            cands.insert(checked.begin(), checked.end());
         }
         nfaces.push_back(face);
     }
-    nfaces.insert(nfaces.end(), tfaces.begin(), tfaces.end());
     return nfaces;
 }
@@ -19,12 +19,23 @@
 long long v_in_verts(const hvector_t& v, const std::vector<hvector_t>& verts);
 //
 //  Remove duplicate vertices in `verts` and rearrange `faces`.
-std::pair<harray2d_t, hfaces_t> reduce_verts(const harray2d_t& verts,
-                                             const hfaces_t& faces);
+std::pair<harray2d_t, hcfaces_t> reduce_verts(const harray2d_t& verts,
+                                              const hcfaces_t& faces);
+
+//  Remove duplicate vertices in `verts` and rearrange `faces` (legacy face list).
+inline std::pair<harray2d_t, hfaces_t> reduce_verts(const harray2d_t& verts,
+                                                    const hfaces_t& faces)
+{
+    auto [r_verts, r_faces] = reduce_verts(verts, to_cfaces(faces));
+    return std::make_pair(std::move(r_verts), to_faces(r_faces));
+}
 
 //  Return edges in the face.
 hedgelist_t face2edges(const hface_t& face);
 
+//  Return edges in the face (compressed face list item).
+hedgelist_t face2edges(std::span<const hindex_t> face);
+
 //  Sort edges orientation, so the first vertex has lower index.
 hedgelist_t sort_edges(const hedgelist_t& edges);
 
@@ -57,4 +68,10 @@ hface_t merge_edges(const hedgelist_t& edges1, const hedgelist_t& edges2,
                     const hedgelist_t& chain);
 
 // Reduce faces by removing duplicate edges.
-hfaces_t reduce_faces(const hfaces_t& faces);
+hcfaces_t reduce_faces(const hcfaces_t& faces);
+
+// Reduce faces by removing duplicate edges (legacy face list).
+inline hfaces_t reduce_faces(const hfaces_t& faces)
+{
+    return to_faces(reduce_faces(to_cfaces(faces)));
+}
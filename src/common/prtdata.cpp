@@ -28,6 +28,7 @@
 #include <fmt/ostream.h>
 #include <fmt/ranges.h>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -47,7 +48,7 @@ void print_header(const char* prog_name, const char* prog_ver, const char* prog_
                   int verb, int ind, int ts)
 {
     const auto sf = ind * ts;
-    const auto vsil = g_cfg[j_verbosity][j_silent].get<int>();
+    const auto vsil = g_cfgs.verb.silent;
     if (verb >= vsil) {
         iprint(sf, "{:s} version {:s} - {:s}\n", prog_name, prog_ver, prog_desc);
     }
@@ -57,7 +58,7 @@ void print_header(const char* prog_name, const char* prog_ver, const char* prog_
 void print_misc(const json& jd, const char* prog_name, int verb, int ind, int ts)
 {
     const auto sf = ind * ts;
-    const auto vdef = g_cfg[j_verbosity][j_default].get<int>();
+    const auto vdef = g_cfgs.verb.def;
     if (verb >= vdef) {
         const std::vector<std::pair<std::string, std::string>> msg_templ = {
             {"Time stamp", jd[j_time].get<std::string>()},
@@ -102,6 +103,17 @@ void print_fov(const json& jd, int ind, int ts)
     iprint(sf, "{:{}s}{:10.2f} {:s}\n", "top:", s1, jd[j_deg_top].get<double>(), DEG);
     iprint(sf, "{:{}s}{:10.2f} {:s}\n", "horiz.:", s1, jd[j_deg_hor].get<double>(), DEG);
     iprint(sf, "{:{}s}{:10.2f} {:s}\n", "vert.:", s1, jd[j_deg_ver].get<double>(), DEG);
+    // FOV profile (counter-clockwise from the right), if calculated
+    if (jd.contains(j_fov_profile)) {
+        constexpr size_t per_line = 8;
+        const auto prof = jd[j_fov_profile].get<std::vector<double>>();
+        iprint(sf, "profile: ({:d} samples, {:s})\n", prof.size(), DEG);
+        for (size_t i = 0, e = prof.size(); i < e; i += per_line) {
+            const auto last = std::min(i + per_line, e);
+            iprint(sf + ts, "{:.2f}\n",
+                   fmt::join(prof.cbegin() + i, prof.cbegin() + last, " "));
+        }
+    }
 }
 
 //  Print total stereo FOV values in degrees.
@@ -201,8 +213,8 @@ void print_render_desc(const json& jd, int ind, int ts)
 //  Print all the info about the view geometry, calculated FOVs, hidden area mesh, etc.
 void print_geometry(const json& jd, int verb, int ind, int ts)
 {
-    const auto vdef = g_cfg[j_verbosity][j_default].get<int>();
-    const auto vgeom = g_cfg[j_verbosity][j_geometry].get<int>();
+    const auto vdef = g_cfgs.verb.def;
+    const auto vgeom = g_cfgs.verb.geom;
     const auto sf = ind * ts;
 
     if (verb < vdef) {
@@ -218,44 +230,44 @@ void print_geometry(const json& jd, int verb, int ind, int ts)
         if (jd.contains(j_ham_mesh)) {
             iprint(sf, "{:s} eye HAM mesh:\n", neye);
             print_ham_mesh(jd[j_ham_mesh][neye], verb, vgeom, ind + 1, ts);
-            fmt::print("\n");
+            oprint("\n");
         }
         if (verb >= vgeom) {
             if (jd.contains(j_eye2head)) {
                 const harray2d_t e2h = jd[j_eye2head][neye];
                 iprint(sf, "{:s} eye to head transformation matrix:\n", neye);
                 print_harray(e2h, ind + 1, ts);
-                fmt::print("\n");
+                oprint("\n");
             }
 
             if (jd.contains(j_raw_eye)) {
                 iprint(sf, "{:s} eye raw LRBT values:\n", neye);
                 print_raw_lrbt(jd[j_raw_eye][neye], ind + 1, ts);
-                fmt::print("\n");
+                oprint("\n");
             }
 
             if (jd.contains(j_render_desc)) {
                 iprint(sf, "{:s} eye render description:\n", neye);
                 print_render_desc(jd[j_render_desc][neye], ind + 1, ts);
-                fmt::print("\n");
+                oprint("\n");
             }
         }
         // print eye FOV points only if eye FOV is different from head FOV
         if (jd.contains(j_fov_eye) && !jd[j_fov_eye].is_null()) {
             iprint(sf, "{:s} eye raw FOV:\n", neye);
             print_fov(jd[j_fov_eye][neye], ind + 1, ts);
-            fmt::print("\n");
+            oprint("\n");
         }
         if (jd.contains(j_fov_head)) {
             iprint(sf, "{:s} eye head FOV:\n", neye);
             print_fov(jd[j_fov_head][neye], ind + 1, ts);
-            fmt::print("\n");
+            oprint("\n");
         }
     }
     if (jd.contains(j_fov_tot)) {
         iprint(sf, "Total FOV:\n");
         print_fov_total(jd[j_fov_tot], ind + 1, ts);
-        fmt::print("\n");
+        oprint("\n");
     }
     if (jd.contains(j_view_geom)) {
         iprint(sf, "View geometry:\n");
@@ -280,16 +292,18 @@ bool have_sensible_data(const json& jd)
 void print_all(const print_options& opts, const json& out, const procmap_t& processors,
                int ind, int ts)
 {
-    const auto vdef = g_cfg[j_verbosity][j_default].get<int>();
-    const auto vsil = g_cfg[j_verbosity][j_silent].get<int>();
-    const auto verr = g_cfg[j_verbosity][j_error].get<int>();
+    const auto vdef = g_cfgs.verb.def;
+    const auto vsil = g_cfgs.verb.silent;
+    const auto verr = g_cfgs.verb.error;
     const auto sf = ind * ts;
     const auto log_ver = out[j_misc][j_log_ver].get<int>();
+    // buffer the output and write it out in large chunks
+    OutSink sink(stdout);
 
     // print the miscellanous (system and app) data
     if (opts.verbosity >= vdef) {
         print_misc(out[j_misc], PROG_HMDQ_NAME, opts.verbosity, ind, ts);
-        fmt::print("\n");
+        oprint("\n");
         // print all the VR from different processors
         bool printed = false;
         for (const auto& [proc_id, proc] : processors) {
@@ -300,9 +314,9 @@ void print_all(const print_options& opts, const json& out, const procmap_t& proc
                 if (have_sensible_data(*pjdata) || opts.verbosity >= verr) {
                     iprint(sf, "... Subsystem: {} ...\n",
                            get_jkey_pretty(proc->get_id()));
-                    fmt::print("\n");
+                    oprint("\n");
                     proc->print(opts, ind, ts);
-                    fmt::print("\n");
+                    oprint("\n");
                     printed = true;
                 }
             }
@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 //  globals
 //------------------------------------------------------------------------------
 //  Error reporting pre-defs
@@ -35,6 +37,7 @@ struct print_options {
         , ovr_max_fov(false)
         , dbg_raw_in(false)
         , dbg_raw_out(false)
+        , fov_profile(0)
         , verbosity(0)
         , mode(pmode::all)
     {}
@@ -45,6 +48,7 @@ struct print_options {
     bool ovr_max_fov; // show Oculus max FOV
     bool dbg_raw_in; // read collected data from JSON file into the processor
     bool dbg_raw_out; // write collected data into JSON file without any processing
+    size_t fov_profile; // number of FOV profile samples (0 = no FOV profile)
     int verbosity; // output verbosity
     pmode mode; // print mode
 };
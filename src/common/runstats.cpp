@@ -0,0 +1,144 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#include <common/except.h>
+#include <common/runstats.h>
+
+#include <algorithm>
+#include <cmath>
+
+//  locals
+//------------------------------------------------------------------------------
+//  Return the exact quantile (with linear interpolation) of the sorted sample.
+static double exact_quantile(const std::vector<double>& sorted, double prob)
+{
+    const auto pos = prob * static_cast<double>(sorted.size() - 1);
+    const auto lo = static_cast<size_t>(std::floor(pos));
+    const auto hi = std::min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (pos - static_cast<double>(lo)) * (sorted[hi] - sorted[lo]);
+}
+
+//  P2Quantile class
+//------------------------------------------------------------------------------
+P2Quantile::P2Quantile(double prob)
+    : m_prob(prob)
+{
+    m_dn = {0, prob / 2, prob, (1 + prob) / 2, 1};
+}
+
+void P2Quantile::init(const std::vector<double>& sorted)
+{
+    HMDQ_ASSERT(sorted.size() >= m_q.size());
+    const auto last = static_cast<double>(sorted.size() - 1);
+    m_np = {0, last * m_prob / 2, last * m_prob, last * (1 + m_prob) / 2, last};
+    // put the markers at the nearest (distinct) ranks of the desired positions
+    for (size_t i = 0; i < m_n.size(); ++i) {
+        const auto lo = i == 0 ? 0. : m_n[i - 1] + 1;
+        const auto hi = last - static_cast<double>(m_n.size() - 1 - i);
+        m_n[i] = std::clamp(std::round(m_np[i]), lo, hi);
+        m_q[i] = sorted[static_cast<size_t>(m_n[i])];
+    }
+}
+
+void P2Quantile::add(double x)
+{
+    // find the cell of the observation (extend the extreme markers if needed)
+    size_t k = 0;
+    if (x < m_q[0]) {
+        m_q[0] = x;
+    } else if (x >= m_q[4]) {
+        m_q[4] = x;
+        k = 3;
+    } else {
+        while (x >= m_q[k + 1]) {
+            ++k;
+        }
+    }
+    for (size_t i = k + 1; i < m_n.size(); ++i) {
+        m_n[i] += 1;
+    }
+    for (size_t i = 0; i < m_np.size(); ++i) {
+        m_np[i] += m_dn[i];
+    }
+
+    // move the middle markers towards their desired positions
+    for (size_t i = 1; i < 4; ++i) {
+        const auto d = m_np[i] - m_n[i];
+        if ((d >= 1 && m_n[i + 1] - m_n[i] > 1)
+            || (d <= -1 && m_n[i - 1] - m_n[i] < -1)) {
+            const double s = d > 0 ? 1 : -1;
+            // piecewise-parabolic prediction
+            const auto qp = m_q[i]
+                + s / (m_n[i + 1] - m_n[i - 1])
+                    * ((m_n[i] - m_n[i - 1] + s) * (m_q[i + 1] - m_q[i])
+                           / (m_n[i + 1] - m_n[i])
+                       + (m_n[i + 1] - m_n[i] - s) * (m_q[i] - m_q[i - 1])
+                           / (m_n[i] - m_n[i - 1]));
+            if (m_q[i - 1] < qp && qp < m_q[i + 1]) {
+                m_q[i] = qp;
+            } else {
+                // fall back to the linear prediction
+                const auto j = d > 0 ? i + 1 : i - 1;
+                m_q[i] += s * (m_q[j] - m_q[i]) / (m_n[j] - m_n[i]);
+            }
+            m_n[i] += s;
+        }
+    }
+}
+
+//  RunningStats class
+//------------------------------------------------------------------------------
+RunningStats::RunningStats(const std::vector<double>& probs)
+    : m_probs(probs)
+{}
+
+void RunningStats::add(double x)
+{
+    if (m_count == 0) {
+        m_min = m_max = x;
+    } else {
+        m_min = std::min(m_min, x);
+        m_max = std::max(m_max, x);
+    }
+    ++m_count;
+    m_mean += (x - m_mean) / static_cast<double>(m_count);
+
+    if (m_count <= EXACT_SIZE) {
+        m_sample.push_back(x);
+        return;
+    }
+    if (m_count == EXACT_SIZE + 1) {
+        // the sample is full, hand it over to the estimators
+        std::sort(m_sample.begin(), m_sample.end());
+        for (const auto prob : m_probs) {
+            m_quants.emplace_back(prob).init(m_sample);
+        }
+        m_sample.clear();
+        m_sample.shrink_to_fit();
+    }
+    for (auto& quant : m_quants) {
+        quant.add(x);
+    }
+}
+
+double RunningStats::quantile(size_t i) const
+{
+    HMDQ_ASSERT(i < m_probs.size());
+    if (m_count == 0) {
+        return 0;
+    }
+    if (m_count > EXACT_SIZE) {
+        return m_quants[i].value();
+    }
+    auto sorted = m_sample;
+    std::sort(sorted.begin(), sorted.end());
+    return exact_quantile(sorted, m_probs[i]);
+}
@@ -0,0 +1,92 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+//  Streaming estimate of one quantile with the P-square algorithm (R. Jain and
+//  I. Chlamtac, 1985). Only five markers are kept regardless of the number of the
+//  observations.
+class P2Quantile
+{
+  public:
+    //  Estimate the quantile `prob` (0 <= prob <= 1).
+    explicit P2Quantile(double prob);
+
+  public:
+    //  Set the initial markers from the sorted sample (at least 5 observations).
+    void init(const std::vector<double>& sorted);
+    //  Add the observation (after `init`).
+    void add(double x);
+    //  Return the current estimate.
+    double value() const
+    {
+        return m_q[2];
+    }
+
+  private:
+    double m_prob;
+    // marker heights
+    std::array<double, 5> m_q{};
+    // actual and desired marker positions and the desired position increments
+    std::array<double, 5> m_n{};
+    std::array<double, 5> m_np{};
+    std::array<double, 5> m_dn{};
+};
+
+//  Running aggregates (count, min, max, mean and the selected quantiles) of a sample
+//  which is not kept in memory. The quantiles of the first `EXACT_SIZE` observations
+//  are exact, the larger samples switch to the P-square estimates.
+class RunningStats
+{
+  public:
+    static constexpr size_t EXACT_SIZE = 64;
+
+  public:
+    //  Track the quantiles `probs` (0 <= prob <= 1) in addition to the basic stats.
+    explicit RunningStats(const std::vector<double>& probs = {});
+
+  public:
+    //  Add the observation.
+    void add(double x);
+
+    size_t count() const
+    {
+        return m_count;
+    }
+    double min() const
+    {
+        return m_min;
+    }
+    double max() const
+    {
+        return m_max;
+    }
+    double mean() const
+    {
+        return m_mean;
+    }
+    //  Return the i-th quantile given in the constructor (0 if there is no data).
+    double quantile(size_t i) const;
+
+  private:
+    std::vector<double> m_probs;
+    size_t m_count = 0;
+    double m_min = 0;
+    double m_max = 0;
+    double m_mean = 0;
+    // the first observations (until the estimators take over)
+    std::vector<double> m_sample;
+    std::vector<P2Quantile> m_quants;
+};
@@ -0,0 +1,143 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#include <common/tpool.h>
+
+#include <algorithm>
+
+//  ThreadPool class
+//------------------------------------------------------------------------------
+ThreadPool::ThreadPool(size_t nthreads)
+{
+    if (nthreads == 0) {
+        nthreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // all queues must exist before the first worker starts stealing
+    for (size_t i = 0; i < nthreads; ++i) {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+    m_workers.reserve(nthreads);
+    for (size_t i = 0; i < nthreads; ++i) {
+        m_workers.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(m_mtx);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+//  Queue the task into the worker's own queue (or into the shared one).
+void ThreadPool::push(std::function<void()> task)
+{
+    auto& queue = (s_pool == this) ? *m_queues[s_wid] : m_shared;
+    {
+        // count under the queue lock, so the task cannot be taken before it is counted
+        std::lock_guard lock(queue.mtx);
+        queue.tasks.push_back({std::move(task), queue.next_seq++});
+        ++m_pending;
+    }
+    {
+        // sync with the sleeping worker, so it cannot miss the notification
+        std::lock_guard lock(m_mtx);
+    }
+    m_cv.notify_one();
+}
+
+//  Get the next task for the worker `wid`: the newest one from its own queue, then
+//  the oldest one from the shared queue, then steal the oldest one from the other
+//  workers.
+bool ThreadPool::pop(size_t wid, Task& task)
+{
+    const auto take = [this, &task](WorkQueue& queue, bool newest) {
+        std::lock_guard lock(queue.mtx);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        if (newest) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        --m_pending;
+        return true;
+    };
+
+    if (take(*m_queues[wid], true) || take(m_shared, false)) {
+        return true;
+    }
+    const auto nqueues = m_queues.size();
+    for (size_t i = 1; i < nqueues; ++i) {
+        if (take(*m_queues[(wid + i) % nqueues], false)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//  Run the newest subtask of the current task from the worker's own queue (if there
+//  is any left), the older tasks there belong to the tasks waiting below.
+bool ThreadPool::run_subtask()
+{
+    if (s_pool != this) {
+        return false;
+    }
+    auto& queue = *m_queues[s_wid];
+    Task task;
+    {
+        std::lock_guard lock(queue.mtx);
+        if (queue.tasks.empty() || queue.tasks.back().seq < s_mark) {
+            return false;
+        }
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        --m_pending;
+    }
+    run(s_wid, task);
+    return true;
+}
+
+//  Run the task in the worker `wid`, the tasks it queues are its subtasks.
+void ThreadPool::run(size_t wid, Task& task)
+{
+    const auto mark = s_mark;
+    s_mark = m_queues[wid]->next_seq;
+    task.func();
+    s_mark = mark;
+}
+
+//  Worker loop, run the tasks until the pool is stopped and all queues are empty.
+void ThreadPool::work(size_t wid)
+{
+    s_pool = this;
+    s_wid = wid;
+    while (true) {
+        Task task;
+        if (pop(wid, task)) {
+            run(wid, task);
+            continue;
+        }
+        std::unique_lock lock(m_mtx);
+        m_cv.wait(lock, [this]() { return m_stop || m_pending > 0; });
+        if (m_stop && m_pending == 0) {
+            return;
+        }
+    }
+}
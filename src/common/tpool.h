@@ -0,0 +1,135 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+//  Pool of worker threads with a work-stealing scheduler. Each worker has its own task
+//  queue, the tasks submitted from a worker go to its queue and are run in LIFO order
+//  by the worker, while the idle workers steal the oldest tasks from the others. The
+//  tasks submitted from the outside go to the shared queue (FIFO).
+//
+//  A task may submit subtasks and wait for them with `wait`, the waiting worker runs
+//  meanwhile only the subtasks of its current task still left in its queue (so the
+//  waits nest no deeper than the task tree), then blocks until the others finish
+//  the stolen ones. The destructor finishes all queued tasks before joining the
+//  workers.
+class ThreadPool
+{
+  public:
+    //  Start `nthreads` workers (or one per hardware thread if `nthreads` is 0).
+    explicit ThreadPool(size_t nthreads = 0);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+  public:
+    //  Return the number of the worker threads.
+    size_t size() const
+    {
+        return m_queues.size();
+    }
+
+    //  Queue the task, return the future for its result (or exception).
+    template <typename F>
+    std::future<std::invoke_result_t<F>> submit(F&& func)
+    {
+        using res_t = std::invoke_result_t<F>;
+        auto task = std::make_shared<std::packaged_task<res_t()>>(std::forward<F>(func));
+        auto res = task->get_future();
+        push([task]() { (*task)(); });
+        return res;
+    }
+
+    //  Wait for the future while running the queued subtasks of the current task,
+    //  return its result. Nothing else can be queued for the waiting thread, so when
+    //  there is no subtask left, it blocks on the future.
+    template <typename T>
+    T wait(std::future<T>& fut)
+    {
+        while (fut.wait_for(std::chrono::seconds(0)) != std::future_status::ready
+               && run_subtask()) {
+        }
+        return fut.get();
+    }
+
+    //  Wait for all the futures, rethrow the first exception only after all the tasks
+    //  have finished (so they do not outlive the data they work on).
+    template <typename T>
+    void wait_all(std::vector<std::future<T>>& futs)
+    {
+        std::exception_ptr eptr;
+        for (auto& fut : futs) {
+            try {
+                wait(fut);
+            } catch (...) {
+                if (!eptr) {
+                    eptr = std::current_exception();
+                }
+            }
+        }
+        if (eptr) {
+            std::rethrow_exception(eptr);
+        }
+    }
+
+  private:
+    //  Queued task with its sequence number in the queue
+    struct Task {
+        std::function<void()> func;
+        uint64_t seq = 0;
+    };
+
+    //  Task queue of one worker
+    struct WorkQueue {
+        std::mutex mtx;
+        std::deque<Task> tasks;
+        // the sequence number of the next queued task (only the owner queues)
+        uint64_t next_seq = 0;
+    };
+
+    void push(std::function<void()> task);
+    bool pop(size_t wid, Task& task);
+    bool run_subtask();
+    void run(size_t wid, Task& task);
+    void work(size_t wid);
+
+  private:
+    static constexpr size_t NO_WORKER = static_cast<size_t>(-1);
+    // the pool and the worker index of the current thread
+    static inline thread_local const ThreadPool* s_pool = nullptr;
+    static inline thread_local size_t s_wid = NO_WORKER;
+    // the first sequence number in the worker's queue queued by its current task
+    static inline thread_local uint64_t s_mark = 0;
+
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    // tasks submitted from the outside of the pool
+    WorkQueue m_shared;
+    std::vector<std::thread> m_workers;
+    // the number of queued tasks (the idle workers sleep while it is 0)
+    std::atomic<size_t> m_pending = 0;
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    bool m_stop = false;
+};
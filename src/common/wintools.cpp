@@ -18,6 +18,7 @@
 #include <winver.h>
 
 #include <cassert>
+#include <cstdint>
 #include <filesystem>
 #include <numeric>
 #include <sstream>
@@ -215,3 +216,75 @@ void print_u8args(std::vector<std::string> u8args)
     }
     fmt::print("\n");
 }
+
+//  Map the whole file into memory (read-only).
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    HANDLE hFile = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                 OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (INVALID_HANDLE_VALUE == hFile) {
+        return;
+    }
+    m_hFile = hFile;
+
+    LARGE_INTEGER fsize{};
+    if (!::GetFileSizeEx(hFile, &fsize) || 0 == fsize.QuadPart
+        || static_cast<unsigned long long>(fsize.QuadPart) > SIZE_MAX) {
+        // empty (or too big) files cannot be mapped
+        close();
+        return;
+    }
+
+    HANDLE hMapping = ::CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (nullptr == hMapping) {
+        close();
+        return;
+    }
+    m_hMapping = hMapping;
+
+    const void* view = ::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    if (nullptr == view) {
+        close();
+        return;
+    }
+    m_data = static_cast<const char*>(view);
+    m_size = static_cast<size_t>(fsize.QuadPart);
+}
+
+//  Unmap the view and close the file.
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+//  Release all handles
+void MappedFile::close()
+{
+    if (nullptr != m_data) {
+        ::UnmapViewOfFile(m_data);
+        m_data = nullptr;
+        m_size = 0;
+    }
+    if (nullptr != m_hMapping) {
+        ::CloseHandle(m_hMapping);
+        m_hMapping = nullptr;
+    }
+    if (nullptr != m_hFile) {
+        ::CloseHandle(m_hFile);
+        m_hFile = nullptr;
+    }
+}
+
+//  Flush the file buffers to the disk.
+bool flush_file(const std::filesystem::path& path)
+{
+    HANDLE hFile = ::CreateFileW(path.c_str(), GENERIC_WRITE,
+                                 FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                 OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (INVALID_HANDLE_VALUE == hFile) {
+        return false;
+    }
+    const auto res = ::FlushFileBuffers(hFile);
+    ::CloseHandle(hFile);
+    return 0 != res;
+}
@@ -43,6 +43,45 @@ std::filesystem::path get_full_prog_path();
 //  Print command line arguments (for debugging purposes)
 void print_u8args(std::vector<std::string> u8args);
 
+//  Read-only memory mapped file. If the file cannot be mapped (e.g. it is empty),
+//  `is_mapped` returns false and the caller is supposed to read the file the usual way.
+class MappedFile
+{
+  public:
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool is_mapped() const
+    {
+        return nullptr != m_data;
+    }
+    const char* data() const
+    {
+        return m_data;
+    }
+    size_t size() const
+    {
+        return m_size;
+    }
+
+  private:
+    // release all handles
+    void close();
+
+  private:
+    void* m_hFile = nullptr;
+    void* m_hMapping = nullptr;
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+//  Flush the file buffers to the disk (the file may be open elsewhere too), return
+//  false if it fails.
+bool flush_file(const std::filesystem::path& path);
+
 //  Convert wstring to UTF-8 string
 inline std::string wstr_to_utf8(const std::wstring& wstr)
 {
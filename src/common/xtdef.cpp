@@ -14,6 +14,8 @@
 
 #include <xtensor/xview.hpp>
 
+#include <limits>
+
 //  functions
 //------------------------------------------------------------------------------
 //  Build the 2D-array from std::vector of 1D-arrays.
@@ -27,3 +29,59 @@ harray2d_t build_array(const hveclist_t& vecs)
     }
     return res;
 }
+
+//  Convert the face list into the compressed face list.
+hcfaces_t to_cfaces(const hfaces_t& faces)
+{
+    size_t nindices = 0;
+    for (const auto& f : faces) {
+        nindices += f.size();
+    }
+    hcfaces_t res;
+    res.reserve(faces.size(), nindices);
+    for (const auto& f : faces) {
+        res.push_back(f);
+    }
+    return res;
+}
+
+//  Convert the compressed face list into the face list.
+hfaces_t to_faces(const hcfaces_t& cfaces)
+{
+    hfaces_t res;
+    res.reserve(cfaces.size());
+    for (size_t i = 0, e = cfaces.size(); i < e; ++i) {
+        const auto f = cfaces[i];
+        res.emplace_back(f.begin(), f.end());
+    }
+    return res;
+}
+
+//  nlohmann/json serializers
+//------------------------------------------------------------------------------
+//  hcfaces_t serializers (stored as a list of faces, same as hfaces_t)
+void to_json(json& j, const hcfaces_t& cfaces)
+{
+    j = json::array();
+    for (size_t i = 0, e = cfaces.size(); i < e; ++i) {
+        const auto f = cfaces[i];
+        json jf = json::array();
+        for (const auto v : f) {
+            jf.push_back(v);
+        }
+        j.push_back(std::move(jf));
+    }
+}
+
+void from_json(const json& j, hcfaces_t& cfaces)
+{
+    cfaces = hcfaces_t();
+    cfaces.offsets.reserve(j.size() + 1);
+    for (const auto& jf : j) {
+        for (const auto& jv : jf) {
+            cfaces.indices.push_back(jv.get<hindex_t>());
+        }
+        HMDQ_ASSERT(cfaces.indices.size() <= std::numeric_limits<hindex_t>::max());
+        cfaces.offsets.push_back(static_cast<hindex_t>(cfaces.indices.size()));
+    }
+}
@@ -11,16 +11,26 @@
 
 #pragma once
 
+#include <common/except.h>
 #include <common/fmthlp.h>
+#include <common/json_proxy.h>
 
 #include <xtensor/xarray.hpp>
-#include <xtensor/xio.hpp>
 #include <xtensor/xtensor.hpp>
 
 #include <fmt/format.h>
 
-#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <span>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 //  typedefs
@@ -34,41 +44,389 @@ typedef std::vector<hvector_t> hveclist_t;
 typedef std::pair<hvector_t, hvector_t> hvecpair_t;
 typedef std::pair<size_t, size_t> hedge_t;
 typedef std::vector<hedge_t> hedgelist_t;
+typedef uint32_t hindex_t;
+
+//  Compressed (CSR) list of faces. The vertex indices of the face `i` are stored in
+//  `indices` in the range [offsets[i], offsets[i + 1]).
+struct hcfaces_t {
+    hcfaces_t() = default;
+
+    //  Return the number of faces.
+    size_t size() const
+    {
+        return offsets.size() - 1;
+    }
+
+    //  Return the vertex indices of the face `i`.
+    std::span<const hindex_t> operator[](size_t i) const
+    {
+        return {indices.data() + offsets[i], indices.data() + offsets[i + 1]};
+    }
+
+    //  Reserve the space for `nfaces` faces with `nindices` vertex indices in total.
+    void reserve(size_t nfaces, size_t nindices)
+    {
+        offsets.reserve(nfaces + 1);
+        indices.reserve(nindices);
+    }
+
+    //  Append the face given by the vertex indices in [first, last).
+    template <typename It>
+    void push_back(It first, It last)
+    {
+        for (; first != last; ++first) {
+            HMDQ_ASSERT(std::in_range<hindex_t>(*first));
+            indices.push_back(static_cast<hindex_t>(*first));
+        }
+        HMDQ_ASSERT(indices.size() <= std::numeric_limits<hindex_t>::max());
+        offsets.push_back(static_cast<hindex_t>(indices.size()));
+    }
+
+    //  Append the face given by the vertex indices.
+    template <typename Face>
+    void push_back(const Face& face)
+    {
+        push_back(std::begin(face), std::end(face));
+    }
+
+    //  Append the face given by the vertex indices.
+    void push_back(std::initializer_list<hindex_t> face)
+    {
+        push_back(face.begin(), face.end());
+    }
+
+    bool operator==(const hcfaces_t& other) const = default;
+
+    std::vector<hindex_t> offsets = {0};
+    std::vector<hindex_t> indices;
+};
 
 //  utility functions
 //------------------------------------------------------------------------------
 //  Build the 2D-array from std::vector of 1D-arrays.
 harray2d_t build_array(const hveclist_t& vecs);
 
-//  Indent print xarray.
+//  Convert the face list into the compressed face list.
+hcfaces_t to_cfaces(const hfaces_t& faces);
+
+//  Convert the compressed face list into the face list.
+hfaces_t to_faces(const hcfaces_t& cfaces);
+
+//  nlohmann/json serializers
+//------------------------------------------------------------------------------
+//  hcfaces_t serializers (stored as a list of faces, same as hfaces_t)
+void to_json(json& j, const hcfaces_t& cfaces);
+void from_json(const json& j, hcfaces_t& cfaces);
+
+//  tensor formatter
+//------------------------------------------------------------------------------
+//  The formatter produces the same layout as xtensor's `operator<<` (`xio.hpp`) with
+//  the default print options, but writes directly into the fmt buffer.
+namespace detail {
+
+//  default `xt::print_options`
+constexpr size_t TENSOR_THRESHOLD = 1000;
+constexpr size_t TENSOR_EDGE_ITEMS = 3;
+constexpr size_t TENSOR_LINE_WIDTH = 75;
+constexpr int TENSOR_PRECISION = 6;
+
+//  Tensor element formatter (collects the stats over all elements first).
+template <typename T, typename Enable = void>
+class TensorElemFmt;
+
+//  Floating point element formatter.
+template <typename T>
+class TensorElemFmt<T, std::enable_if_t<std::is_floating_point_v<T>>>
+{
+  public:
+    void update(T val)
+    {
+        if (val != 0 && std::isfinite(val)) {
+            if (!m_scientific || !m_large_exp) {
+                const auto exponent = 1 + static_cast<int>(std::log10(std::abs(val)));
+                if (exponent <= -5 || exponent > 7) {
+                    m_scientific = true;
+                    m_req_prec = TENSOR_PRECISION;
+                    if (exponent <= -100 || exponent >= 100) {
+                        m_large_exp = true;
+                    }
+                }
+            }
+            m_max = std::max(m_max, std::abs(val));
+            // the smallest precision which prints the value exactly
+            while (m_req_prec < TENSOR_PRECISION
+                   && std::floor(val * std::pow(10, m_req_prec))
+                          != val * std::pow(10, m_req_prec)) {
+                ++m_req_prec;
+            }
+        }
+        if (std::signbit(val)) {
+            m_sign = true;
+        }
+    }
+
+    void init()
+    {
+        m_prec = std::min(m_req_prec, TENSOR_PRECISION);
+        if (m_scientific) {
+            // sign, digit, dot and "e+00"
+            m_width = m_prec + 7 + (m_large_exp ? 1 : 0);
+        } else {
+            int digits = 1;
+            if (std::floor(m_max) != 0) {
+                digits += static_cast<int>(std::log10(std::floor(m_max)));
+            }
+            // sign and dot
+            m_width = 2 + digits + m_prec;
+        }
+        if (!m_sign) {
+            --m_width;
+        }
+    }
+
+    int width() const
+    {
+        return m_width;
+    }
+
+    void format(fmt::memory_buffer& buf, T val) const
+    {
+        const auto start = buf.size();
+        if (!m_scientific) {
+            fmt::format_to(std::back_inserter(buf), "{:{}.{}f}", val, m_width, m_prec);
+            if (m_prec == 0 && std::isfinite(val)) {
+                buf.push_back('.');
+            }
+            // trailing zeros are replaced by spaces
+            for (auto i = buf.size(); i > start && buf[i - 1] == '0'; --i) {
+                buf[i - 1] = ' ';
+            }
+        } else {
+            fmt::format_to(std::back_inserter(buf), "{:{}.{}e}", val, m_width, m_prec);
+            const auto end = buf.size();
+            if (m_large_exp && buf[end - 4] == 'e') {
+                // make the exponent 3 digits long (e.g. "e+05" -> "e+005")
+                const auto data = buf.data();
+                std::copy(data + start + 1, data + end - 2, data + start);
+                buf[end - 3] = '0';
+            }
+        }
+    }
+
+  private:
+    bool m_scientific = false;
+    bool m_large_exp = false;
+    bool m_sign = false;
+    int m_req_prec = 0;
+    int m_prec = 0;
+    int m_width = 0;
+    T m_max = 0;
+};
+
+//  Integer element formatter.
+template <typename T>
+class TensorElemFmt<
+    T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>>
+{
+  public:
+    void update(T val)
+    {
+        if constexpr (std::is_signed_v<T>) {
+            if (val < 0) {
+                m_sign = true;
+                val = -val;
+            }
+        }
+        m_max = std::max(m_max, val);
+    }
+
+    void init()
+    {
+        const auto digits = m_max > 0 ? std::log10(static_cast<double>(m_max)) : 0;
+        m_width = 1 + static_cast<int>(digits) + (m_sign ? 1 : 0);
+    }
+
+    int width() const
+    {
+        return m_width;
+    }
+
+    void format(fmt::memory_buffer& buf, T val) const
+    {
+        fmt::format_to(std::back_inserter(buf), "{:>{}}", val, m_width);
+    }
+
+  private:
+    bool m_sign = false;
+    int m_width = 0;
+    T m_max = 0;
+};
+
+//  Boolean element formatter.
+template <>
+class TensorElemFmt<bool>
+{
+  public:
+    void update(bool) {}
+    void init() {}
+
+    int width() const
+    {
+        return 5;
+    }
+
+    void format(fmt::memory_buffer& buf, bool val) const
+    {
+        const std::string_view res = val ? " true" : "false";
+        buf.append(res.data(), res.data() + res.size());
+    }
+};
+
+//  Tensor formatter, prints only the edge items of the big tensors.
 template <typename T, int N>
-std::vector<std::string> format_tensor(const xt::xtensor<T, N>& a)
+class TensorFormatter
 {
-    // stringstream to dump the xarray
-    std::stringstream temp;
-    temp << a;
+  public:
+    explicit TensorFormatter(const xt::xtensor<T, N>& a)
+        : m_a(a)
+    {
+        if (m_a.size() > TENSOR_THRESHOLD) {
+            m_lim = TENSOR_EDGE_ITEMS;
+        }
+        if (m_a.size() > 0) {
+            scan(0, 0);
+        }
+        m_efmt.init();
+    }
 
-    std::vector<std::string> res;
-    for (std::string line; getline(temp, line);) {
-        res.push_back(line);
+    void format(fmt::memory_buffer& buf) const
+    {
+        if (m_a.size() == 0) {
+            append(buf, "{}");
+        } else {
+            output(buf, 0, 0);
+        }
     }
-    return res;
+
+  private:
+    //  Return the next index to print in the dimension of size `n`.
+    size_t next(size_t i, size_t n) const
+    {
+        return (m_lim && n > 2 * m_lim && i == m_lim) ? n - m_lim : i;
+    }
+
+    static void append(fmt::memory_buffer& buf, std::string_view text)
+    {
+        buf.append(text.data(), text.data() + text.size());
+    }
+
+    static void newline(fmt::memory_buffer& buf, size_t blanks)
+    {
+        buf.push_back('\n');
+        for (size_t i = 0; i < blanks; ++i) {
+            buf.push_back(' ');
+        }
+    }
+
+    //  Feed the printed elements into the element formatter.
+    void scan(size_t dim, size_t offset)
+    {
+        if (dim == N) {
+            m_efmt.update(m_a.data()[offset]);
+            return;
+        }
+        const auto n = m_a.shape()[dim];
+        for (size_t i = 0; i < n; ++i) {
+            i = next(i, n);
+            scan(dim + 1, offset + i * m_a.strides()[dim]);
+        }
+    }
+
+    void output(fmt::memory_buffer& buf, size_t dim, size_t offset) const
+    {
+        if (dim == N) {
+            m_efmt.format(buf, m_a.data()[offset]);
+            return;
+        }
+        const auto n = m_a.shape()[dim];
+        const auto stride = static_cast<size_t>(m_a.strides()[dim]);
+        const auto blanks = dim + 1;
+        const auto last = dim == N - 1;
+        const auto line_lim = TENSOR_LINE_WIDTH / (m_efmt.width() + 2);
+        // the elements in the last dimension are wrapped at the line width
+        const auto wrap = [&](size_t elems) {
+            return last && line_lim != 0 && elems >= line_lim;
+        };
+
+        size_t elems = 0;
+        buf.push_back('{');
+        for (size_t i = 0; i < n - 1; ++i) {
+            if (next(i, n) != i) {
+                if (wrap(elems)) {
+                    append(buf, " ...,");
+                } else if (!last) {
+                    elems = 0;
+                    append(buf, "...,");
+                    newline(buf, blanks);
+                } else {
+                    append(buf, "..., ");
+                }
+                i = next(i, n);
+            }
+            if (wrap(elems)) {
+                newline(buf, blanks);
+                elems = 0;
+            }
+            output(buf, dim + 1, offset + i * stride);
+            buf.push_back(',');
+            ++elems;
+            if (!last) {
+                newline(buf, blanks);
+            } else if (!wrap(elems)) {
+                buf.push_back(' ');
+            }
+        }
+        if (wrap(elems)) {
+            newline(buf, blanks);
+        }
+        output(buf, dim + 1, offset + (n - 1) * stride);
+        buf.push_back('}');
+    }
+
+    const xt::xtensor<T, N>& m_a;
+    TensorElemFmt<T> m_efmt;
+    size_t m_lim = 0;
+};
+
+} // namespace detail
+
+//  Format xtensor into the buffer (in the same layout as `xio` prints it). The lines
+//  are separated by '\n', the last one is not terminated.
+template <typename T, int N>
+void format_tensor(fmt::memory_buffer& buf, const xt::xtensor<T, N>& a)
+{
+    detail::TensorFormatter<T, N>(a).format(buf);
 }
 
-inline void print_multiline(const std::vector<std::string>& lines, int ind, int ts)
+//  Indent print multiline text.
+inline void print_multiline(std::string_view text, int ind, int ts)
 {
     const auto sf = ind * ts;
-    for (const auto line : lines) {
-        iprint(sf, "{}\n", line);
+    for (auto eol = text.find('\n'); eol != std::string_view::npos;
+         eol = text.find('\n')) {
+        iprint(sf, "{}\n", text.substr(0, eol));
+        text.remove_prefix(eol + 1);
     }
+    iprint(sf, "{}\n", text);
 }
 
-//  Indent print xarray.
+//  Indent print xtensor.
 template <typename T, int N>
 void print_tensor(const xt::xtensor<T, N>& a, int ind, int ts)
 {
-    const auto fval = format_tensor<T, N>(a);
-    print_multiline(fval, ind, ts);
+    fmt::memory_buffer buf;
+    format_tensor<T, N>(buf, a);
+    print_multiline({buf.data(), buf.size()}, ind, ts);
 }
 
 inline void print_harray(const harray2d_t& a, int ind, int ts)
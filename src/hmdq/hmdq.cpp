@@ -62,7 +62,6 @@ enum class mode { geom, props, all, info, help };
 //------------------------------------------------------------------------------
 static constexpr int IND = 0;
 static constexpr unsigned int CP_UTF8 = 65001;
-const auto OPENVR_API_JSON = "openvr_api.json";
 
 //  log versions
 //------------------------------------------------------------------------------
@@ -152,12 +151,15 @@ static pmode mode2pmode(const mode selected)
 
 //  main runner
 int run(const print_options& opts, const std::filesystem::path& api_json,
-        const std::filesystem::path& out_json, int ind, int ts)
+        const std::filesystem::path& out_json, const std::string& out_format, int ind,
+        int ts)
 {
+    // check the output format before doing anything
+    const auto format = get_jformat(out_format);
     // initialize config values
-    const auto json_indent = g_cfg[j_format][j_json_indent].get<int>();
-    const auto vdef = g_cfg[j_verbosity][j_default].get<int>();
-    const auto verr = g_cfg[j_verbosity][j_error].get<int>();
+    const auto json_indent = g_cfgs.json_indent;
+    const auto vdef = g_cfgs.verb.def;
+    const auto verr = g_cfgs.verb.error;
 
     // print the execution header
     print_header(HMDQ_NAME, HMDQ_VERSION, HMDQ_DESCRIPTION, opts.verbosity, ind, ts);
@@ -225,7 +227,7 @@ int run(const print_options& opts, const std::filesystem::path& api_json,
             if (processors.find(col_id) != processors.end()) {
                 auto proc = processors[col_id].get();
                 proc->init();
-                proc->calculate();
+                proc->calculate(opts.fov_profile);
                 if (opts.anonymize) {
                     proc->anonymize();
                 }
@@ -251,12 +253,9 @@ int run(const print_options& opts, const std::filesystem::path& api_json,
 
     // dump the data into the optional JSON file
     if (!out_json.empty()) {
-        if (!raw_read) {
-            // add the checksum (but only when the data are authentic)
-            add_checksum(out);
-        }
-        // save the JSON file with indentation
-        write_json(out_json, out, json_indent);
+        // save the JSON file with indentation (or in the binary format), add the
+        // checksum (but only when the data are authentic)
+        write_json(out_json, out, json_indent, format, !raw_read);
     }
 
     return 0;
@@ -264,11 +263,12 @@ int run(const print_options& opts, const std::filesystem::path& api_json,
 
 //  wrapper for main runner to deal with domestic exceptions
 int run_wrapper(const print_options& opts, const std::filesystem::path& api_json,
-                const std::filesystem::path& out_json, int ind, int ts)
+                const std::filesystem::path& out_json, const std::string& out_format,
+                int ind, int ts)
 {
     int res = 0;
     try {
-        res = run(opts, api_json, out_json, ind, ts);
+        res = run(opts, api_json, out_json, out_format, ind, ts);
     } catch (hmdq_error e) {
         fmt::print(stderr, ERR_MSG_FMT_OUT, e.what());
         res = 1;
@@ -305,30 +305,30 @@ int main(int argc, char* argv[])
     if (!cfg_ok)
         return 1;
 
-    const auto ts = g_cfg[j_format][j_cli_indent].get<int>();
+    const auto ts = g_cfgs.cli_indent;
     const auto ind = IND;
 
     print_options opts;
 
     // defaults for the arguments
-    opts.verbosity = g_cfg[j_verbosity][j_default].get<int>();
-    opts.anonymize = g_cfg[j_control][j_anonymize].get<bool>();
+    opts.verbosity = g_cfgs.verb.def;
+    opts.anonymize = g_cfgs.anonymize;
 
     // default command is 'all'
     mode cmd = mode::all;
 
-    // build relative path to OPENVR_API_JSON file
-    auto api_json_path = get_full_prog_path();
-    api_json_path.replace_filename(OPENVR_API_JSON);
-    auto api_json = path_to_utf8(api_json_path);
+    // OpenVR API definition is built in, the file is only an (optional) override
+    std::string api_json;
 
     std::string out_json;
+    std::string out_format = "json";
     // custom help texts
     const auto verb_help = fmt::format("verbosity level [{}]", opts.verbosity);
-    const auto api_json_help
-        = fmt::format("OpenVR API JSON definition file [\"{}\"]", api_json);
+    const auto api_json_help = std::string("OpenVR API JSON definition file [built-in]");
     const auto anon_help
         = fmt::format("anonymize serial numbers in the output [{}]", opts.anonymize);
+    const auto format_help
+        = fmt::format("output file format (json, cbor, msgpack) [{}]", out_format);
 
     // Use this construct to accept an "empty" command. First parse all
     // together (cli_cmds, cli_opts) then cli_opts to accept also only the
@@ -336,6 +336,7 @@ int main(int argc, char* argv[])
     const auto cli_opts
         = ((option("-a", "--api_json") & value("name", api_json)) % api_json_help,
            (option("-o", "--out_json") & value("name", out_json)) % "JSON output file",
+           (option("-f", "--format") & value("name", out_format)) % format_help,
            (option("-v", "--verb").set(opts.verbosity, 1)
             & opt_value("level", opts.verbosity))
                % verb_help,
@@ -346,6 +347,8 @@ int main(int argc, char* argv[])
             % "show only Oculus data"),
            (option("--ovr_max_fov").set(opts.ovr_max_fov, true)
             % "show also Oculus max FOV data"),
+           (option("--fov_profile") & value("num", opts.fov_profile))
+               % "add FOV profile sampled at <num> polar angles [0]",
            (option("--dbg_raw_in").set(opts.dbg_raw_in, true)
             % "read raw collected data from JSON file into the processor (debug)"),
            (option("--dbg_raw_out").set(opts.dbg_raw_out, true)
@@ -378,7 +381,7 @@ int main(int argc, char* argv[])
             case mode::all:
                 opts.mode = mode2pmode(cmd);
                 res = run_wrapper(opts, utf8_to_path(api_json), utf8_to_path(out_json),
-                                  ind, ts);
+                                  out_format, ind, ts);
                 break;
             case mode::help:
                 fmt::print("Usage:\n{:s}\nOptions:\n{:s}\n",
@@ -388,8 +391,8 @@ int main(int argc, char* argv[])
     } else {
         if (parse(std::next(u8args.cbegin()), u8args.cend(), cli_nocmd)) {
             opts.mode = mode2pmode(mode::all);
-            res = run_wrapper(opts, utf8_to_path(api_json), utf8_to_path(out_json), ind,
-                              ts);
+            res = run_wrapper(opts, utf8_to_path(api_json), utf8_to_path(out_json),
+                              out_format, ind, ts);
         } else {
             fmt::print("Usage:\n{:s}\n", usage_lines(cli, HMDQ_NAME).str());
             res = 1;
@@ -161,13 +161,10 @@ json get_val_mat_array(const std::vector<unsigned char>& buffer, size_t buffsize
 }
 
 //  Get array of <prop_name> type into a JSON dict.
-json prop_array_to_json(const std::string& pname,
+json prop_array_to_json(const basevr::PropDesc& pdesc,
                         const std::vector<unsigned char>& buffer)
 {
-    // parse the name to get the type
-    const auto [basename, ptype_name, ptype, is_array] = basevr::parse_prop_name(pname);
-
-    switch (ptype) {
+    switch (pdesc.ptype) {
         case basevr::PropType::Bool:
             return get_val_1d_array<bool>(buffer, buffer.size());
         case basevr::PropType::Float:
@@ -197,7 +194,7 @@ json prop_array_to_json(const std::string& pname,
         case basevr::PropType::Vector4:
             return get_val_vec_array<vr::HmdVector4_t>(buffer, buffer.size());
         default:
-            const auto msg = fmt::format(MSG_TYPE_NOT_IMPL, ptype_name);
+            const auto msg = fmt::format(MSG_TYPE_NOT_IMPL, pdesc.type_name);
             return make_error_obj(msg);
     }
 }
@@ -232,18 +229,17 @@ get_array_tracked_prop(vr::IVRSystem* vrsys, vr::TrackedDeviceIndex_t did,
 
 //  Universal routine to get any scalar or array property into the JSON dict.
 json get_any_type_prop(vr::IVRSystem* vrsys, vr::TrackedDeviceIndex_t did,
-                       vr::ETrackedDeviceProperty pid, const std::string& pname)
+                       const basevr::PropDesc& pdesc)
 {
     vr::ETrackedPropertyError error = vr::TrackedProp_Success;
-    // parse the name to get the type
-    const auto [basename, ptype_name, ptype, is_array] = basevr::parse_prop_name(pname);
+    const auto pid = static_cast<vr::ETrackedDeviceProperty>(pdesc.pid);
 
-    if (ptype == basevr::PropType::Invalid) {
-        const auto msg = fmt::format(MSG_TYPE_NOT_IMPL, ptype_name);
+    if (pdesc.ptype == basevr::PropType::Invalid) {
+        const auto msg = fmt::format(MSG_TYPE_NOT_IMPL, pdesc.type_name);
         return make_error_obj(msg);
     }
 
-    vr::PropertyTypeTag_t ptag = ptype_to_ptag(ptype);
+    vr::PropertyTypeTag_t ptag = ptype_to_ptag(pdesc.ptype);
     std::vector<unsigned char> aval
         = get_array_tracked_prop(vrsys, did, pid, ptag, &error);
 
@@ -251,13 +247,13 @@ json get_any_type_prop(vr::IVRSystem* vrsys, vr::TrackedDeviceIndex_t did,
         return get_tp_error(vrsys, error);
     }
 
-    if (ptype == basevr::PropType::String) {
+    if (pdesc.ptype == basevr::PropType::String) {
         // for String type interpret directly the buffer as a string
         return reinterpret_cast<char*>(&aval[0]);
     }
 
-    json temp = prop_array_to_json(pname, aval);
-    if (is_array) {
+    json temp = prop_array_to_json(pdesc, aval);
+    if (pdesc.is_array) {
         return temp;
     } else {
         // if not dealing with an array property "remove" the array (brackets)
@@ -268,60 +264,64 @@ json get_any_type_prop(vr::IVRSystem* vrsys, vr::TrackedDeviceIndex_t did,
 //  Return dict of properties for device `did` in the range
 json get_dev_props_range(vr::IVRSystem* vrsys, vr::TrackedDeviceIndex_t did,
                          vr::ETrackedDeviceClass dclass, int cat, int min_pid,
-                         int max_pid, const json& api)
+                         int max_pid, const basevr::PropIndex& pindex)
 {
-    const auto scat = std::to_string(cat);
     json res;
 
-    vr::ETrackedPropertyError error = vr::TrackedProp_Success;
-    for (const auto& [spid, jname] : api[j_properties][scat].items()) {
-        // convert string to the correct type
-        const auto pid = static_cast<vr::ETrackedDeviceProperty>(std::stoi(spid));
-        if (pid < min_pid || pid >= max_pid) {
+    // the category is implied by the range
+    for (const auto pdesc : pindex.props()) {
+        if (pdesc->pid < min_pid || pdesc->pid >= max_pid) {
             continue;
         }
-        // property name
-        const auto pname = jname.get<std::string>();
         // use all-in-one matic function
-        res[pname] = get_any_type_prop(vrsys, did, pid, pname);
+        res[pdesc->name] = get_any_type_prop(vrsys, did, *pdesc);
     }
     return res;
 }
 
 //  Return dict of properties for device `did`.
 json get_dev_props(vr::IVRSystem* vrsys, vr::TrackedDeviceIndex_t did,
-                   vr::ETrackedDeviceClass dclass, int cat, const json& api)
+                   vr::ETrackedDeviceClass dclass, int cat,
+                   const basevr::PropIndex& pindex)
 {
     return get_dev_props_range(vrsys, did, dclass, cat, cat * 1000, (cat + 1) * 1000,
-                               api);
+                               pindex);
 }
 
 //  Return properties for all devices.
-json get_all_props(vr::IVRSystem* vrsys, const hdevlist_t& devs, const json& api)
+json get_all_props(vr::IVRSystem* vrsys, const hdevlist_t& devs,
+                   const basevr::PropIndex& pindex)
 {
     json pvals;
 
     for (const auto& [did, dclass] : devs) {
         const auto sdid = std::to_string(did);
-        pvals[sdid] = get_dev_props(vrsys, did, dclass, PROP_CAT_COMMON, api);
+        pvals[sdid] = get_dev_props(vrsys, did, dclass, PROP_CAT_COMMON, pindex);
         if (dclass == vr::TrackedDeviceClass_HMD) {
-            pvals[sdid].update(get_dev_props(vrsys, did, dclass, PROP_CAT_HMD, api));
-            pvals[sdid].update(get_dev_props_range(
-                vrsys, did, dclass, PROP_CAT_UI, PROP_CAT_UI_MIN, PROP_CAT_UI_MAX, api));
-            pvals[sdid].update(get_dev_props(vrsys, did, dclass, PROP_CAT_DRIVER, api));
-            pvals[sdid].update(get_dev_props(vrsys, did, dclass, PROP_CAT_INTERNAL, api));
+            pvals[sdid].update(get_dev_props(vrsys, did, dclass, PROP_CAT_HMD, pindex));
+            pvals[sdid].update(get_dev_props_range(vrsys, did, dclass, PROP_CAT_UI,
+                                                   PROP_CAT_UI_MIN, PROP_CAT_UI_MAX,
+                                                   pindex));
+            pvals[sdid].update(
+                get_dev_props(vrsys, did, dclass, PROP_CAT_DRIVER, pindex));
+            pvals[sdid].update(
+                get_dev_props(vrsys, did, dclass, PROP_CAT_INTERNAL, pindex));
         } else if (dclass == vr::TrackedDeviceClass_Controller) {
             pvals[sdid].update(
-                get_dev_props(vrsys, did, dclass, PROP_CAT_CONTROLLER, api));
-            pvals[sdid].update(get_dev_props_range(
-                vrsys, did, dclass, PROP_CAT_UI, PROP_CAT_UI_MIN, PROP_CAT_UI_MAX, api));
-            pvals[sdid].update(get_dev_props(vrsys, did, dclass, PROP_CAT_INTERNAL, api));
+                get_dev_props(vrsys, did, dclass, PROP_CAT_CONTROLLER, pindex));
+            pvals[sdid].update(get_dev_props_range(vrsys, did, dclass, PROP_CAT_UI,
+                                                   PROP_CAT_UI_MIN, PROP_CAT_UI_MAX,
+                                                   pindex));
+            pvals[sdid].update(
+                get_dev_props(vrsys, did, dclass, PROP_CAT_INTERNAL, pindex));
         } else if (dclass == vr::TrackedDeviceClass_TrackingReference) {
             pvals[sdid].update(
-                get_dev_props(vrsys, did, dclass, PROP_CAT_TRACKEDREF, api));
-            pvals[sdid].update(get_dev_props_range(
-                vrsys, did, dclass, PROP_CAT_UI, PROP_CAT_UI_MIN, PROP_CAT_UI_MAX, api));
-            pvals[sdid].update(get_dev_props(vrsys, did, dclass, PROP_CAT_INTERNAL, api));
+                get_dev_props(vrsys, did, dclass, PROP_CAT_TRACKEDREF, pindex));
+            pvals[sdid].update(get_dev_props_range(vrsys, did, dclass, PROP_CAT_UI,
+                                                   PROP_CAT_UI_MIN, PROP_CAT_UI_MAX,
+                                                   pindex));
+            pvals[sdid].update(
+                get_dev_props(vrsys, did, dclass, PROP_CAT_INTERNAL, pindex));
         }
     }
     return pvals;
@@ -416,7 +416,7 @@ json get_geometry(vr::IVRSystem* vrsys)
 }
 
 //  Return some info about OpenVR.
-json get_openvr(vr::IVRSystem* vrsys, const json& api)
+json get_openvr(vr::IVRSystem* vrsys, const basevr::PropIndex& pindex)
 {
     json res;
     res[j_rt_path] = get_runtime_path().string();
@@ -426,7 +426,7 @@ json get_openvr(vr::IVRSystem* vrsys, const json& api)
     if (devs.size()) {
         res[j_devices] = devs;
         // get all the properties
-        res[j_properties] = get_all_props(vrsys, devs, api);
+        res[j_properties] = get_all_props(vrsys, devs, pindex);
         // record geometry only if HMD device class is present
         // this technically should be always true, unless the user explicitly requested
         // running OpenVR without a HMD.
@@ -477,8 +477,8 @@ bool Collector::try_init()
     m_err = error;
     if (nullptr != vrsys) {
         m_ivrSystem = vrsys;
-        json oapi = read_json(m_apiPath);
-        *m_pjApi = parse_json_oapi(oapi);
+        *m_pjApi = load_json_oapi(m_apiPath);
+        m_pPropIndex = get_prop_index(m_pjApi);
         res = true;
     } else {
         add_error(*m_pjData, get_last_error_msg());
@@ -489,7 +489,7 @@ bool Collector::try_init()
 // Collect the OpenVR subsystem data
 void Collector::collect()
 {
-    *m_pjData = get_openvr(m_ivrSystem, *m_pjApi);
+    *m_pjData = get_openvr(m_ivrSystem, *m_pPropIndex);
 }
 
 // Return the last OpenVR subsystem error
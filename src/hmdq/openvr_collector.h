@@ -12,12 +12,14 @@
 #pragma once
 
 #include <common/base_classes.h>
+#include <common/base_common.h>
 #include <common/jkeys.h>
 #include <common/json_proxy.h>
 
 #include <openvr/openvr.h>
 
 #include <filesystem>
+#include <memory>
 #include <string>
 
 namespace openvr {
@@ -65,6 +67,8 @@ class Collector : public BaseVRCollector
     std::filesystem::path m_apiPath;
     // API extract
     std::shared_ptr<json> m_pjApi;
+    // Property descriptor index (over API extract)
+    std::shared_ptr<const basevr::PropIndex> m_pPropIndex;
 };
 
 } // namespace openvr
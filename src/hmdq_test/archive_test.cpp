@@ -0,0 +1,132 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#include <common/archive.h>
+#include <common/jtools.h>
+
+// Already defined in geom_test.cpp
+// #define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+
+#include <fmt/format.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+//  global setup
+//------------------------------------------------------------------------------
+//  Return the entry metadata.
+static json make_meta(const std::string& name, const std::string& model)
+{
+    return {{"name", name}, {"model", model}, {j_hmdq_ver, "2.1.0"}};
+}
+
+//  Return the entry data as a string.
+static std::string to_string(const char* first, const char* last)
+{
+    return std::string(first, last);
+}
+
+//  tests
+//------------------------------------------------------------------------------
+TEST_CASE("Archive", "[archive]")
+{
+    const auto path = std::filesystem::temp_directory_path() / "hmdq_test.hmdqa";
+    std::filesystem::remove(path);
+    const std::vector<std::string> data = {R"({"misc":{"n":0}})", R"({"misc":{"n":1}})",
+                                           R"({"misc":{"n":2}})"};
+    const std::vector<std::string> models = {"Index", "Vive", "Index"};
+    {
+        ArchiveWriter writer(path);
+        for (size_t i = 0; i < data.size(); ++i) {
+            const auto& d = data[i];
+            writer.append(make_meta(fmt::format("f{}.json", i), models[i]), d.data(),
+                          d.data() + d.size());
+        }
+        writer.commit();
+        REQUIRE(writer.size() == data.size());
+    }
+
+    SECTION("entries", "[archive]")
+    {
+        const Archive arc(path);
+        REQUIRE(arc.size() == data.size());
+        for (size_t i = 0; i < data.size(); ++i) {
+            REQUIRE(arc.with_data(i, to_string) == data[i]);
+            REQUIRE(arc.meta(i)["model"] == models[i]);
+        }
+        REQUIRE_THROWS_AS(arc.with_data(data.size(), to_string), hmdq_error);
+    }
+
+    SECTION("selectors", "[archive]")
+    {
+        const Archive arc(path);
+        REQUIRE(arc.select("") == std::vector<size_t>{0, 1, 2});
+        REQUIRE(arc.select("1") == std::vector<size_t>{1});
+        REQUIRE(arc.select("model=Index") == std::vector<size_t>{0, 2});
+        REQUIRE(arc.select("model=Index,name=f2.json") == std::vector<size_t>{2});
+        REQUIRE(arc.select("model=Rift").empty());
+        REQUIRE(arc.select_one("model=Vive") == 1);
+        REQUIRE_THROWS_AS(arc.select_one("model=Index"), hmdq_error);
+        REQUIRE_THROWS_AS(arc.select("Index"), hmdq_error);
+    }
+
+    SECTION("entry paths", "[archive]")
+    {
+        std::filesystem::path apath;
+        std::string selector;
+        REQUIRE(split_archive_path(path, apath, selector));
+        REQUIRE((apath == path && selector.empty()));
+        auto epath = path;
+        epath += "#model=Vive";
+        REQUIRE(split_archive_path(epath, apath, selector));
+        REQUIRE((apath == path && selector == "model=Vive"));
+        REQUIRE(read_json(epath)[j_misc]["n"] == 1);
+        REQUIRE(read_json(archive_entry_path(path, 2))[j_misc]["n"] == 2);
+        REQUIRE(read_json_sections(archive_entry_path(path, 0), {"/misc"})[j_misc]["n"]
+                == 0);
+    }
+
+    SECTION("append", "[archive]")
+    {
+        const std::string d = R"({"misc":{"n":3}})";
+        ArchiveWriter writer(path);
+        REQUIRE(writer.size() == data.size());
+        writer.append(make_meta("f3.json", "Rift"), d.data(), d.data() + d.size());
+        // not visible until committed
+        REQUIRE(Archive(path).size() == data.size());
+        writer.commit();
+        const Archive arc(path);
+        REQUIRE(arc.size() == data.size() + 1);
+        REQUIRE(arc.select_one("model=Rift") == data.size());
+        REQUIRE(arc.with_data(0, to_string) == data[0]);
+    }
+
+    SECTION("shared archive", "[archive]")
+    {
+        const auto parc = open_archive(path);
+        REQUIRE(open_archive(path) == parc);
+        REQUIRE(parc->with_data(1, to_string) == data[1]);
+        // the entries are read from the open archive
+        REQUIRE(read_json(archive_entry_path(path, 1))[j_misc]["n"] == 1);
+    }
+
+    SECTION("not an archive", "[archive]")
+    {
+        std::ofstream(path, std::ios::binary) << "{}";
+        REQUIRE(!is_archive(path));
+        REQUIRE_THROWS_AS(Archive(path), hmdq_error);
+    }
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,56 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#include <common/base_common.h>
+
+// Already defined in geom_test.cpp
+// #define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+
+//  tests
+//------------------------------------------------------------------------------
+TEST_CASE("Property descriptor index", "[base_common]")
+{
+    const std::unordered_map<std::string, int> verb_props
+        = {{"Prop_SerialNumber_String", 0}};
+    basevr::PropIndex pindex(verb_props, 3);
+
+    SECTION("parsed descriptors", "[prop_index]")
+    {
+        const auto& serial = pindex.add("Prop_SerialNumber_String", 1002);
+        REQUIRE(serial.pid == 1002);
+        REQUIRE(serial.basename == "SerialNumber");
+        REQUIRE(serial.ptype == basevr::PropType::String);
+        REQUIRE(!serial.is_array);
+        REQUIRE(serial.verb == 0);
+
+        const auto& modes
+            = pindex.add("Prop_DisplayAvailableFrameRates_Float_Array", 2100);
+        REQUIRE(modes.basename == "DisplayAvailableFrameRates");
+        REQUIRE(modes.type_name == "Float_Array");
+        REQUIRE(modes.ptype == basevr::PropType::Float);
+        REQUIRE(modes.is_array);
+        REQUIRE(modes.verb == 3);
+    }
+
+    SECTION("lookup", "[prop_index]")
+    {
+        const auto& first = pindex.add("Prop_ModelNumber_String", 1001);
+        // adding again returns the original descriptor
+        REQUIRE(&pindex.add("Prop_ModelNumber_String") == &first);
+        REQUIRE(pindex.find("Prop_ModelNumber_String") == &first);
+        REQUIRE(pindex.find("Prop_Unknown_String") == nullptr);
+        pindex.add("Prop_SerialNumber_String", 1002);
+        REQUIRE(pindex.props().size() == 2);
+        REQUIRE(pindex.props()[1]->pid == 1002);
+    }
+}
@@ -0,0 +1,68 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#include <common/fmthlp.h>
+
+// Already defined in geom_test.cpp
+// #define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+
+#include <string>
+
+//  tests
+//------------------------------------------------------------------------------
+TEST_CASE("Output sink", "[fmthlp]")
+{
+    SECTION("print into string", "[out_sink]")
+    {
+        std::string text;
+        {
+            OutSink sink(text);
+            iprint(4, "{}: {:.2f}\n", "value", 1.5);
+            oprint("{}\n", 42);
+            REQUIRE(OutSink::current() == &sink);
+            // nothing written until flushed
+            REQUIRE(text.empty());
+        }
+        REQUIRE(OutSink::current() == nullptr);
+        REQUIRE(text == "    value: 1.50\n42\n");
+    }
+
+    SECTION("nested sinks", "[out_sink]")
+    {
+        std::string outer_text;
+        std::string inner_text;
+        OutSink outer(outer_text);
+        oprint("outer ");
+        {
+            OutSink inner(inner_text);
+            oprint("inner");
+        }
+        oprint("again");
+        outer.flush();
+        REQUIRE(inner_text == "inner");
+        REQUIRE(outer_text == "outer again");
+    }
+
+    SECTION("large output is flushed in chunks", "[out_sink]")
+    {
+        std::string text;
+        OutSink sink(text);
+        const std::string line(100, 'x');
+        for (int i = 0; i < 1000; ++i) {
+            oprint("{}\n", line);
+        }
+        REQUIRE(!text.empty());
+        sink.flush();
+        REQUIRE(text.size() == 1000 * 101);
+    }
+}
@@ -0,0 +1,133 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#include <common/geom2.h>
+
+// Already defined in geom_test.cpp
+// #define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+
+//  global setup
+//------------------------------------------------------------------------------
+//  HAM in UV space forming a diamond touching the centers of the LRBT rectangle sides
+static const harray2d_t diamond_verts = {{0.5, 0.0}, {1.0, 0.5}, {0.5, 1.0}, {0.0, 0.5}};
+static const hedgelist_t diamond_edges = {{0, 1}, {1, 2}, {2, 3}, {3, 0}};
+
+//  Check that the point `i` in `pts` is (x, y, z).
+static void check_point(const harray2d_t& pts, size_t i, double x, double y, double z)
+{
+    using Approx = Catch::Approx;
+    REQUIRE(pts(i, 0) == Approx(x).margin(geom::DOUBLE_EPS_100));
+    REQUIRE(pts(i, 1) == Approx(y).margin(geom::DOUBLE_EPS_100));
+    REQUIRE(pts(i, 2) == Approx(z).margin(geom::DOUBLE_EPS_100));
+}
+
+//  tests
+//------------------------------------------------------------------------------
+TEST_CASE("frustum geometry", "[geom2]")
+{
+    SECTION("mesh append", "[meshd]")
+    {
+        const harray2d_t verts2 = diamond_verts * 2;
+        const harray2d_t verts3 = diamond_verts * 3;
+        geom::Meshd mesh;
+        mesh.reserve(8, 2, 8);
+        mesh.add_mesh(diamond_verts, diamond_edges);
+        mesh.add_mesh(verts2, diamond_edges);
+        mesh.add_mesh(verts3, diamond_edges);
+        REQUIRE(mesh.vert_count() == 12);
+        REQUIRE(mesh.get_edges().size() == 12);
+        REQUIRE(mesh.get_edges()[4] == hedge_t{4, 5});
+        REQUIRE(mesh.get_edges()[11] == hedge_t{11, 8});
+        const auto& verts = mesh.get_verts();
+        REQUIRE(verts(3, 0) == 0.0);
+        REQUIRE(verts(5, 0) == 2.0);
+        REQUIRE(verts(10, 1) == 3.0);
+    }
+    SECTION("mesh append into reserved space", "[meshd]")
+    {
+        geom::Meshd mesh;
+        mesh.reserve(8, 2, 8);
+        const double* pbuf = mesh.get_verts().data();
+        mesh.add_mesh(diamond_verts, diamond_edges);
+        mesh.add_mesh(diamond_verts, diamond_edges);
+        REQUIRE(mesh.vert_count() == 8);
+        REQUIRE(mesh.get_verts().data() == pbuf);
+    }
+
+    SECTION("FOV profile matches FOV points", "[fov_profile]")
+    {
+        auto frustum = geom::Frustum(-1.2, 1.1, -1.3, 1.0);
+        const auto pts = frustum.get_fov_points(true);
+        const auto prof = frustum.get_fov_profile(4, true);
+        REQUIRE(prof.shape(0) == 4);
+        // R, T, L, B
+        const size_t idx[] = {3, 5, 7, 1};
+        for (size_t i = 0; i < 4; ++i) {
+            check_point(prof, i, pts(idx[i], 0), pts(idx[i], 1), pts(idx[i], 2));
+        }
+    }
+
+    SECTION("FOV profile without HAM", "[fov_profile]")
+    {
+        const auto prof = geom::Frustum(-1, 1, -1, 1).get_fov_profile(8, true);
+        check_point(prof, 0, 1, 0, -1);
+        check_point(prof, 1, 1, 1, -1);
+        check_point(prof, 2, 0, 1, -1);
+        check_point(prof, 3, -1, 1, -1);
+        check_point(prof, 4, -1, 0, -1);
+        check_point(prof, 5, -1, -1, -1);
+        check_point(prof, 6, 0, -1, -1);
+        check_point(prof, 7, 1, -1, -1);
+    }
+
+    SECTION("FOV profile with HAM", "[fov_profile]")
+    {
+        const geom::Meshd ham(diamond_verts, diamond_edges);
+        const auto prof
+            = geom::Frustum(-1, 1, -1, 1, nullptr, &ham).get_fov_profile(8, true);
+        check_point(prof, 0, 1, 0, -1);
+        check_point(prof, 1, 0.5, 0.5, -1);
+        check_point(prof, 2, 0, 1, -1);
+        check_point(prof, 3, -0.5, 0.5, -1);
+        check_point(prof, 4, -1, 0, -1);
+        check_point(prof, 5, -0.5, -0.5, -1);
+        check_point(prof, 6, 0, -1, -1);
+        check_point(prof, 7, 0.5, -0.5, -1);
+    }
+
+    SECTION("shared frustum mesh", "[frustum_mesh]")
+    {
+        const geom::Meshd ham(diamond_verts, diamond_edges);
+        const geom::Rotation rot(0.1, geom::Point3(0, 1, 0));
+        const geom::FrustumMesh fmesh(-1.2, 1.1, -1.3, 1.0, &ham);
+        const geom::Rotation* rots[] = {nullptr, &rot};
+        for (const geom::Rotation* pRot : rots) {
+            const auto pts1 = geom::Frustum(fmesh, pRot).get_fov_points();
+            const auto pts2
+                = geom::Frustum(-1.2, 1.1, -1.3, 1.0, pRot, &ham).get_fov_points();
+            REQUIRE(pts1 == pts2);
+        }
+    }
+
+    SECTION("frustum mesh from HAM buffers", "[frustum_mesh]")
+    {
+        const geom::Meshd ham(diamond_verts, diamond_edges);
+        const geom::FrustumMesh fmesh1(-1.2, 1.1, -1.3, 1.0, &ham);
+        const geom::FrustumMesh fmesh2(-1.2, 1.1, -1.3, 1.0, diamond_verts,
+                                       diamond_edges);
+        REQUIRE(fmesh1.get_mesh().vert_count() == fmesh2.get_mesh().vert_count());
+        REQUIRE(fmesh1.get_mesh().get_edges() == fmesh2.get_mesh().get_edges());
+        REQUIRE(geom::Frustum(fmesh1).get_fov_points()
+                == geom::Frustum(fmesh2).get_fov_points());
+    }
+}
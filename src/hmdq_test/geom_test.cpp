@@ -18,6 +18,8 @@
                           // in one cpp file
 #include <catch2/catch_all.hpp>
 
+#include <random>
+
 //  global setup
 //------------------------------------------------------------------------------
 // generic test samples
@@ -120,4 +122,80 @@ TEST_CASE("geometry module", "[geometry]")
         REQUIRE(area_triangle(o2, a2, o2) == Approx(0));
         REQUIRE(area_triangle(a5, a1, a7 * 2) == Approx(2.0));
     }
+
+    SECTION("clipped triangle surface calculation", "[area_triangle_clip]")
+    {
+        // inside
+        REQUIRE(area_triangle_clip({0, 0}, {1, 0}, {0, 1}) == 0.5);
+        REQUIRE(area_triangle_clip({0, 1}, {1, 0}, {0, 0}) == 0.5);
+        // outside
+        REQUIRE(area_triangle_clip({1, 1}, {2, 1}, {1, 2}) == 0.0);
+        REQUIRE(area_triangle_clip({-1, -1}, {-2, 0}, {0, -2}) == 0.0);
+        // straddling
+        REQUIRE(area_triangle_clip({-1, 0}, {1, 0}, {-1, 2}) == 0.5);
+        REQUIRE(area_triangle_clip({0.5, -1}, {2, 0.5}, {0.5, 2}) == 0.5);
+        REQUIRE(area_triangle_clip({-1, -1}, {3, -1}, {-1, 3}) == 1.0);
+        // degenerated
+        REQUIRE(area_triangle_clip({0, 0}, {0.5, 0.5}, {1, 1}) == 0.0);
+    }
+
+    SECTION("native clipper vs GEOS", "[area_mesh_tris_idx_clip]")
+    {
+        // random triangles spread over the clipping rectangle and around it
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<double> dist(-0.5, 1.5);
+        constexpr size_t ntris = 1000;
+        harray2d_t verts = xt::empty<double>({ntris * 3, size_t{2}});
+        hcfaces_t tris;
+        tris.reserve(ntris, ntris * 3);
+        for (size_t i = 0; i < ntris; ++i) {
+            for (size_t j = 0; j < 3; ++j) {
+                verts(i * 3 + j, 0) = dist(gen);
+                verts(i * 3 + j, 1) = dist(gen);
+            }
+            const auto k = static_cast<hindex_t>(i * 3);
+            tris.push_back({k, k + 1, k + 2});
+        }
+        ClipStats rstats;
+        // two different clipping algorithms, compare with the relative tolerance
+        REQUIRE(area_mesh_tris_idx_clip(verts, tris, &rstats)
+                == Catch::Approx(area_mesh_tris_idx_geos(verts, tris))
+                       .epsilon(HAM_AREA_ALGO_TOLERANCE));
+        REQUIRE(rstats.inside + rstats.outside + rstats.clipped == ntris);
+        for (size_t i = 0; i < ntris; ++i) {
+            hcfaces_t tri;
+            tri.push_back(tris[i]);
+            REQUIRE(area_mesh_tris_idx_clip(verts, tri)
+                    == Catch::Approx(area_mesh_tris_idx_geos(verts, tri))
+                           .epsilon(HAM_AREA_ALGO_TOLERANCE)
+                           .margin(1e-15));
+        }
+
+        // regular grid mesh partially outside the clipping rectangle
+        constexpr hindex_t n = 8;
+        harray2d_t gverts = xt::empty<double>({size_t{(n + 1) * (n + 1)}, size_t{2}});
+        for (hindex_t i = 0; i <= n; ++i) {
+            for (hindex_t j = 0; j <= n; ++j) {
+                gverts(i * (n + 1) + j, 0) = -0.3 + 1.6 * i / n;
+                gverts(i * (n + 1) + j, 1) = -0.3 + 1.6 * j / n;
+            }
+        }
+        hcfaces_t gtris;
+        for (hindex_t i = 0; i < n; ++i) {
+            for (hindex_t j = 0; j < n; ++j) {
+                const hindex_t v = i * (n + 1) + j;
+                gtris.push_back({v, v + 1, v + n + 2});
+                gtris.push_back({v, v + n + 2, v + n + 1});
+            }
+        }
+        ClipStats stats;
+        const auto garea = area_mesh_tris_idx_clip(gverts, gtris, &stats);
+        REQUIRE(garea == Catch::Approx(1.0));
+        REQUIRE(stats.inside == 32);
+        REQUIRE(stats.outside == 56);
+        REQUIRE(stats.clipped == 40);
+        REQUIRE(garea
+                == Catch::Approx(area_mesh_tris_idx_geos(gverts, gtris))
+                       .epsilon(HAM_AREA_ALGO_TOLERANCE));
+    }
 }
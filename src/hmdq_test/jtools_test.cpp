@@ -0,0 +1,266 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#include <common/jtools.h>
+
+// Already defined in geom_test.cpp
+// #define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+
+#include <fmt/format.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+//  global setup
+//------------------------------------------------------------------------------
+//  Build a JSON document resembling a large hmdq dump (with HAM meshes).
+static json make_large_json(size_t nverts)
+{
+    json jd;
+    for (const auto& neye : {j_leye, j_reye}) {
+        json verts = json::array();
+        json faces = json::array();
+        for (size_t i = 0; i < nverts; ++i) {
+            verts.push_back({0.5 + 0.001 * i, 0.25 - 0.0007 * i});
+            if (i % 3 == 2) {
+                faces.push_back({i - 2, i - 1, i});
+            }
+        }
+        jd[j_ham_mesh][neye][j_verts_raw] = std::move(verts);
+        jd[j_ham_mesh][neye][j_faces_raw] = std::move(faces);
+    }
+    jd[j_misc][j_time] = "2026-01-01 00:00:00";
+    return jd;
+}
+
+//  Count the values parsed by SAX parser.
+struct CountingSax : public nlohmann::json_sax<json> {
+    size_t values = 0;
+
+    bool null() override
+    {
+        ++values;
+        return true;
+    }
+    bool boolean(bool) override
+    {
+        ++values;
+        return true;
+    }
+    bool number_integer(number_integer_t) override
+    {
+        ++values;
+        return true;
+    }
+    bool number_unsigned(number_unsigned_t) override
+    {
+        ++values;
+        return true;
+    }
+    bool number_float(number_float_t, const string_t&) override
+    {
+        ++values;
+        return true;
+    }
+    bool string(string_t&) override
+    {
+        ++values;
+        return true;
+    }
+    bool binary(binary_t&) override
+    {
+        ++values;
+        return true;
+    }
+    bool start_object(std::size_t) override
+    {
+        return true;
+    }
+    bool key(string_t&) override
+    {
+        return true;
+    }
+    bool end_object() override
+    {
+        return true;
+    }
+    bool start_array(std::size_t) override
+    {
+        return true;
+    }
+    bool end_array() override
+    {
+        return true;
+    }
+    bool parse_error(std::size_t, const std::string&,
+                     const nlohmann::detail::exception&) override
+    {
+        return false;
+    }
+};
+
+//  tests
+//------------------------------------------------------------------------------
+TEST_CASE("JSON checksum", "[jtools]")
+{
+    SECTION("checksum of the compact dump", "[checksum]")
+    {
+        // Blake2b(128) of '{"a":1,"b":[1.5,null,"x"]}' and '[1,2,3]'
+        const auto jd = json::parse(R"({"a": 1, "b": [1.5, null, "x"]})");
+        REQUIRE(calculate_checksum(jd) == "DD406C918C4BB31DE5A1DD34C40FB641");
+        REQUIRE(calculate_checksum(json::parse("[1, 2, 3]"))
+                == "53C65DEB7D4E0BFC9931D06CFE60790D");
+    }
+
+    SECTION("checksum verification", "[checksum]")
+    {
+        auto jd = json::parse(R"({"a": 1, "b": [1.5, null, "x"]})");
+        REQUIRE(!verify_checksum(jd));
+        add_checksum(jd);
+        REQUIRE(jd[j_checksum] == "DD406C918C4BB31DE5A1DD34C40FB641");
+        REQUIRE(verify_checksum(jd));
+        // the checksum does not have to be the last property
+        jd["c"] = "after";
+        const auto chksm = calculate_checksum(json::parse(R"({"a": 1,
+            "b": [1.5, null, "x"], "c": "after"})"));
+        jd[j_checksum] = chksm;
+        REQUIRE(verify_checksum(jd));
+        jd["c"] = "changed";
+        REQUIRE(!verify_checksum(jd));
+    }
+}
+
+TEST_CASE("JSON file reader", "[jtools]")
+{
+    const auto path = std::filesystem::temp_directory_path() / "hmdq_test_read.json";
+    const auto jd = make_large_json(300);
+    write_json(path, jd, 1);
+
+    SECTION("read_json matches stream parsing", "[read_json]")
+    {
+        json jstream;
+        std::ifstream(path) >> jstream;
+        REQUIRE(read_json(path) == jstream);
+        REQUIRE(read_json(path) == jd);
+    }
+
+    SECTION("SAX parsing", "[read_json]")
+    {
+        CountingSax sax;
+        REQUIRE(sax_parse_json(path, sax));
+        // 2 eyes * (300 verts * 2 + 100 faces * 3) + time
+        REQUIRE(sax.values == 2 * (300 * 2 + 100 * 3) + 1);
+    }
+
+    SECTION("selected sections", "[read_json]")
+    {
+        auto jdc = jd;
+        add_checksum(jdc);
+        write_json(path, jdc, 1);
+
+        bool check_ok = false;
+        const auto misc_ptr = fmt::format("/{}", j_misc);
+        const auto ham_ptr = fmt::format("/{}/{}", j_ham_mesh, j_leye);
+        const auto part = read_json_sections(path, {misc_ptr, ham_ptr}, &check_ok);
+        REQUIRE(check_ok);
+        REQUIRE(part[j_misc] == jd[j_misc]);
+        REQUIRE(part[j_ham_mesh][j_leye] == jd[j_ham_mesh][j_leye]);
+        REQUIRE(!part[j_ham_mesh].contains(j_reye));
+
+        // verify only, nothing loaded
+        REQUIRE(read_json_sections(path, {}, &check_ok).is_null());
+        REQUIRE(check_ok);
+        jdc[j_misc][j_time] = "2026-01-01 00:00:01";
+        write_json(path, jdc, 1);
+        read_json_sections(path, {}, &check_ok);
+        REQUIRE(!check_ok);
+    }
+
+    SECTION("binary formats", "[read_json]")
+    {
+        auto jdc = jd;
+        jdc[j_misc]["floats"] = {1.5, -0.0, 1e-300};
+        jdc[j_misc]["mixed"] = {1.5, 2};
+        add_checksum(jdc);
+        const auto text_size = std::filesystem::file_size(path);
+        for (const auto format : {jformat::cbor, jformat::msgpack}) {
+            write_json(path, jdc, 0, format);
+            REQUIRE(std::filesystem::file_size(path) < text_size);
+            const auto jdb = read_json(path);
+            REQUIRE(jdb.dump() == jdc.dump());
+            REQUIRE(verify_checksum(jdb));
+            bool check_ok = false;
+            const auto part = read_json_sections(path, {"/misc"}, &check_ok);
+            REQUIRE(check_ok);
+            REQUIRE(part[j_misc] == jdc[j_misc]);
+        }
+        REQUIRE_THROWS_AS(get_jformat("xml"), hmdq_error);
+    }
+
+    SECTION("streamed output with checksum", "[write_json]")
+    {
+        auto jdc = jd;
+        jdc[j_checksum] = "stale";
+        jdc[j_misc]["empty"] = json::object();
+        jdc[j_misc]["none"] = json::array();
+        auto expected = jdc;
+        expected.erase(j_checksum);
+        add_checksum(expected);
+        for (const auto indent : {-1, 0, 1, 4}) {
+            write_json(path, jdc, indent, jformat::json, true);
+            std::ifstream jfi(path);
+            const std::string text((std::istreambuf_iterator<char>(jfi)),
+                                   std::istreambuf_iterator<char>());
+            REQUIRE(text == expected.dump(indent));
+        }
+        REQUIRE(verify_checksum(read_json(path)));
+    }
+
+    SECTION("empty file", "[read_json]")
+    {
+        std::ofstream(path).close();
+        REQUIRE_THROWS(read_json(path));
+    }
+
+    std::filesystem::remove(path);
+}
+
+//  Not run by default (hidden), run `hmdq_test "[!benchmark]"` to get the numbers.
+TEST_CASE("JSON file reader benchmark", "[.][!benchmark][jtools]")
+{
+    const auto path = std::filesystem::temp_directory_path() / "hmdq_bench_read.json";
+    write_json(path, make_large_json(200000), 2);
+
+    BENCHMARK("std::ifstream >> json")
+    {
+        json jd;
+        std::ifstream jin(path);
+        jin >> jd;
+        return jd.size();
+    };
+
+    BENCHMARK("read_json")
+    {
+        return read_json(path).size();
+    };
+
+    BENCHMARK("sax_parse_json")
+    {
+        CountingSax sax;
+        sax_parse_json(path, sax);
+        return sax.values;
+    };
+
+    std::filesystem::remove(path);
+}
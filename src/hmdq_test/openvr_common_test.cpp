@@ -0,0 +1,58 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#include <common/jkeys.h>
+#include <common/jtools.h>
+#include <common/openvr_common.h>
+
+#include <openvr_api_table.h>
+
+// Already defined in geom_test.cpp
+// #define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+
+//  tests
+//------------------------------------------------------------------------------
+TEST_CASE("OpenVR API definition", "[openvr]")
+{
+    // OAPI_JSON_PATH is defined in CMakeLists.txt
+    const auto from_file = openvr::parse_json_oapi(read_json(OAPI_JSON_PATH));
+
+    SECTION("built-in table matches the JSON file", "[oapi]")
+    {
+        const auto built_in = openvr::make_json_oapi();
+        // compare the dumps to check the order too
+        REQUIRE(built_in.dump() == from_file.dump());
+        REQUIRE(built_in[j_properties][j_name2id]["Prop_DisplayFrequency_Float"]
+                == 2002);
+        REQUIRE(built_in[j_classes]["1"] == "HMD");
+    }
+
+    SECTION("built-in table parsed names", "[oapi]")
+    {
+        // the name parts generated at build time must match the runtime parser
+        for (const auto& prop : openvr::OAPI_PROPS) {
+            const auto [basename, type_name, ptype, is_array]
+                = basevr::parse_prop_name(prop.name);
+            REQUIRE(basename == prop.basename);
+            REQUIRE(type_name == prop.type_name);
+            REQUIRE(ptype == prop.type);
+            REQUIRE(is_array == prop.is_array);
+        }
+    }
+
+    SECTION("file override", "[oapi]")
+    {
+        REQUIRE(openvr::load_json_oapi({}) == openvr::make_json_oapi());
+        REQUIRE(openvr::load_json_oapi(OAPI_JSON_PATH) == from_file);
+    }
+}
@@ -17,6 +17,8 @@
 
 #include <catch2/catch_all.hpp>
 
+#include <cmath>
+
 //  global setup
 //------------------------------------------------------------------------------
 const hface_t f1 = {1, 2, 3, 4, 5};
@@ -56,6 +58,13 @@ const hfaces_t faces4 = {{1, 2, 5}, {1, 5, 7}, {1, 7, 4}, {2, 5, 6},
                          {2, 6, 3}, {3, 6, 8}, {6, 8, 7}, {8, 4, 7}};
 const hfaces_t nfaces4 = {{6, 5, 7, 4, 1, 2, 3, 8}, {7, 6, 8, 4}};
 
+// vertices with negative zeros, which compare equal to positive ones
+const harray2d_t verts5 = {{0.0, 1.0}, {-0.0, 1.0}, {0.5, -0.0}, {0.5, 0.0},
+                           {1.0, 1.0}, {0.0, 1.0}, {0.5, 0.0}, {1.0, 1.0}};
+const hfaces_t faces5 = {{0, 2, 4}, {1, 3, 7}, {5, 6, 4}};
+const harray2d_t rverts5 = {{0.0, 1.0}, {0.5, -0.0}, {1.0, 1.0}};
+const hfaces_t rfaces5 = {{0, 1, 2}, {0, 1, 2}, {0, 1, 2}};
+
 //  tests
 //------------------------------------------------------------------------------
 TEST_CASE("HAM mesh optimization module", "[optmesh]")
@@ -74,6 +83,11 @@ TEST_CASE("HAM mesh optimization module", "[optmesh]")
         auto [tverts2, tfaces2] = reduce_verts(verts1, faces1);
         REQUIRE(bool(tverts2 == verts2));
         REQUIRE(tfaces2 == faces2);
+
+        auto [tverts5, tfaces5] = reduce_verts(verts5, faces5);
+        REQUIRE(bool(tverts5 == rverts5));
+        REQUIRE(std::signbit(tverts5(1, 1)));
+        REQUIRE(tfaces5 == rfaces5);
     }
 
     SECTION("convert faces to edges", "[face2edges]")
@@ -233,4 +247,23 @@ TEST_CASE("HAM mesh optimization module", "[optmesh]")
 
         REQUIRE(nfaces4 == reduce_faces(faces4));
     }
+
+    SECTION("compressed face list", "[hcfaces_t]")
+    {
+        const auto cfaces4 = to_cfaces(faces4);
+        REQUIRE(cfaces4.size() == faces4.size());
+        REQUIRE(cfaces4.offsets.size() == faces4.size() + 1);
+        REQUIRE(cfaces4.indices.size() == 3 * faces4.size());
+        REQUIRE(faces4 == to_faces(cfaces4));
+        REQUIRE(hcfaces_t() == to_cfaces(hfaces_t()));
+
+        REQUIRE(to_cfaces(nfaces4) == reduce_faces(cfaces4));
+        auto [tverts2, tfaces2] = reduce_verts(verts1, to_cfaces(faces1));
+        REQUIRE(bool(tverts2 == verts2));
+        REQUIRE(tfaces2 == to_cfaces(faces2));
+
+        const json jfaces4 = cfaces4;
+        REQUIRE(jfaces4 == json(faces4));
+        REQUIRE(jfaces4.get<hcfaces_t>() == cfaces4);
+    }
 }
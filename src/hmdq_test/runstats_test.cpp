@@ -0,0 +1,85 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#include <common/runstats.h>
+
+// Already defined in geom_test.cpp
+// #define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+//  global setup
+//------------------------------------------------------------------------------
+//  Return the exact quantile (with linear interpolation) of the sorted sample.
+static double exact_quantile(const std::vector<double>& sorted, double prob)
+{
+    const auto pos = prob * static_cast<double>(sorted.size() - 1);
+    const auto lo = static_cast<size_t>(std::floor(pos));
+    const auto hi = std::min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (pos - static_cast<double>(lo)) * (sorted[hi] - sorted[lo]);
+}
+
+//  tests
+//------------------------------------------------------------------------------
+TEST_CASE("Running stats", "[runstats]")
+{
+    const std::vector<double> probs = {0.05, 0.25, 0.5, 0.75, 0.95};
+
+    SECTION("few observations", "[runstats]")
+    {
+        RunningStats rs(probs);
+        REQUIRE(rs.count() == 0);
+        REQUIRE(rs.quantile(2) == 0);
+        const std::vector<double> sample = {4, 1, 3, 2};
+        for (const auto x : sample) {
+            rs.add(x);
+        }
+        REQUIRE(rs.count() == 4);
+        REQUIRE(rs.min() == 1);
+        REQUIRE(rs.max() == 4);
+        REQUIRE(rs.mean() == Catch::Approx(2.5));
+        auto sorted = sample;
+        std::sort(sorted.begin(), sorted.end());
+        for (size_t i = 0; i < probs.size(); ++i) {
+            REQUIRE(rs.quantile(i) == Catch::Approx(exact_quantile(sorted, probs[i])));
+        }
+    }
+
+    SECTION("large sample", "[runstats]")
+    {
+        std::mt19937 gen(42);
+        std::normal_distribution<double> dist(100, 10);
+        RunningStats rs(probs);
+        std::vector<double> sample;
+        for (int i = 0; i < 10000; ++i) {
+            sample.push_back(dist(gen));
+            rs.add(sample.back());
+        }
+        std::sort(sample.begin(), sample.end());
+        REQUIRE(rs.count() == sample.size());
+        REQUIRE(rs.min() == sample.front());
+        REQUIRE(rs.max() == sample.back());
+        double sum = 0;
+        for (const auto x : sample) {
+            sum += x;
+        }
+        REQUIRE(rs.mean() == Catch::Approx(sum / sample.size()));
+        // the estimates are within a fraction of the standard deviation
+        for (size_t i = 0; i < probs.size(); ++i) {
+            REQUIRE(std::abs(rs.quantile(i) - exact_quantile(sample, probs[i])) < 0.5);
+        }
+    }
+}
@@ -0,0 +1,133 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#include <common/except.h>
+#include <common/tpool.h>
+
+// Already defined in geom_test.cpp
+// #define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+//  global setup
+//------------------------------------------------------------------------------
+//  Calculate Fibonacci number spawning the subtasks (to test the nested waiting).
+static long fib(ThreadPool& pool, int n)
+{
+    if (n < 2) {
+        return n;
+    }
+    auto f1 = pool.submit([&pool, n]() { return fib(pool, n - 1); });
+    const auto f2 = fib(pool, n - 2);
+    return pool.wait(f1) + f2;
+}
+
+//  tests
+//------------------------------------------------------------------------------
+TEST_CASE("Thread pool", "[tpool]")
+{
+    SECTION("results", "[tpool]")
+    {
+        std::vector<std::future<int>> results;
+        {
+            ThreadPool pool(4);
+            REQUIRE(pool.size() == 4);
+            for (int i = 0; i < 1000; ++i) {
+                results.push_back(pool.submit([i]() { return i * 2; }));
+            }
+        }
+        for (int i = 0; i < 1000; ++i) {
+            REQUIRE(results[i].get() == i * 2);
+        }
+    }
+
+    SECTION("exceptions", "[tpool]")
+    {
+        ThreadPool pool(2);
+        auto res = pool.submit([]() -> int { throw hmdq_error("failed"); });
+        REQUIRE_THROWS_AS(res.get(), hmdq_error);
+    }
+
+    SECTION("nested tasks", "[tpool]")
+    {
+        // a single worker must not deadlock waiting for its own subtasks
+        for (const size_t nthreads : {1, 2, 8}) {
+            ThreadPool pool(nthreads);
+            auto res = pool.submit([&pool]() { return fib(pool, 20); });
+            REQUIRE(res.get() == 6765);
+        }
+    }
+
+    SECTION("waiting for all subtasks", "[tpool]")
+    {
+        ThreadPool pool(4);
+        std::atomic<int> count = 0;
+        auto res = pool.submit([&pool, &count]() {
+            std::vector<std::future<void>> tasks;
+            for (int i = 0; i < 16; ++i) {
+                tasks.push_back(pool.submit([i, &count]() {
+                    ++count;
+                    if (i == 3) {
+                        throw hmdq_error("failed");
+                    }
+                }));
+            }
+            pool.wait_all(tasks);
+        });
+        REQUIRE_THROWS_AS(res.get(), hmdq_error);
+        // all subtasks finished before the exception was rethrown
+        REQUIRE(count == 16);
+    }
+
+    SECTION("waiting does not run unrelated tasks", "[tpool]")
+    {
+        // the waiting task must not pick up the other top level tasks
+        static thread_local int depth = 0;
+        std::atomic<int> max_depth = 0;
+        ThreadPool pool(4);
+        std::vector<std::future<void>> tasks;
+        for (int i = 0; i < 100; ++i) {
+            tasks.push_back(pool.submit([&pool, &max_depth]() {
+                if (++depth > max_depth) {
+                    max_depth = depth;
+                }
+                std::vector<std::future<void>> subtasks;
+                for (int j = 0; j < 4; ++j) {
+                    subtasks.push_back(pool.submit([]() {
+                        std::this_thread::sleep_for(std::chrono::microseconds(100));
+                    }));
+                }
+                pool.wait_all(subtasks);
+                --depth;
+            }));
+        }
+        pool.wait_all(tasks);
+        REQUIRE(max_depth == 1);
+    }
+
+    SECTION("queued tasks finish before the pool is destroyed", "[tpool]")
+    {
+        std::atomic<int> count = 0;
+        {
+            ThreadPool pool;
+            REQUIRE(pool.size() > 0);
+            for (int i = 0; i < 100; ++i) {
+                pool.submit([&count]() { ++count; });
+            }
+        }
+        REQUIRE(count == 100);
+    }
+}
@@ -0,0 +1,104 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#include <common/xtdef.h>
+
+// Already defined in geom_test.cpp
+// #define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+
+#include <xtensor/xbuilder.hpp>
+#include <xtensor/xio.hpp>
+
+#include <sstream>
+#include <string>
+
+//  global setup
+//------------------------------------------------------------------------------
+//  Format the tensor by `format_tensor`.
+template <typename T, int N>
+static std::string fmt_tensor(const xt::xtensor<T, N>& a)
+{
+    fmt::memory_buffer buf;
+    format_tensor<T, N>(buf, a);
+    return fmt::to_string(buf);
+}
+
+//  Format the tensor by xtensor's `xio` printer.
+template <typename T, int N>
+static std::string xio_tensor(const xt::xtensor<T, N>& a)
+{
+    std::stringstream temp;
+    temp << a;
+    return temp.str();
+}
+
+//  tests
+//------------------------------------------------------------------------------
+TEST_CASE("Tensor formatter", "[xtdef]")
+{
+    SECTION("layout", "[format_tensor]")
+    {
+        const hvector_t v = {1.0, 0.0, 0.5};
+        REQUIRE(fmt_tensor<double, 1>(v) == "{1. , 0. , 0.5}");
+        const harray2d_t e2h = {{1.0, 0.0, 0.0, 0.032},
+                                {0.0, 1.0, 0.0, 0.0},
+                                {0.0, 0.0, 1.0, -0.015}};
+        REQUIRE(fmt_tensor<double, 2>(e2h)
+                == "{{ 1.   ,  0.   ,  0.   ,  0.032},\n"
+                   " { 0.   ,  1.   ,  0.   ,  0.   },\n"
+                   " { 0.   ,  0.   ,  1.   , -0.015}}");
+        const xt::xtensor<bool, 1> b = {true, false};
+        REQUIRE(fmt_tensor<bool, 1>(b) == "{ true, false}");
+        REQUIRE(fmt_tensor<double, 1>(hvector_t()) == "{}");
+    }
+
+    SECTION("same as xio", "[format_tensor]")
+    {
+        const xt::xtensor<double, 3> m34 = {{{0.999, 0.01, -0.002, -0.0321},
+                                             {-0.01, 0.999, 0.0, 0.0},
+                                             {0.002, 0.0, 0.999, 0.015}},
+                                            {{1.0, 0.0, 0.0, 0.0321},
+                                             {0.0, 1.0, 0.0, 0.0},
+                                             {0.0, 0.0, 1.0, 0.015}}};
+        REQUIRE(fmt_tensor<double, 3>(m34) == xio_tensor<double, 3>(m34));
+        const xt::xtensor<double, 2> v2 = {{1e-7, 2.5}, {1e120, -3.0}};
+        REQUIRE(fmt_tensor<double, 2>(v2) == xio_tensor<double, 2>(v2));
+        const xt::xtensor<int32_t, 1> i32 = {1, -20, 300, 4, 5};
+        REQUIRE(fmt_tensor<int32_t, 1>(i32) == xio_tensor<int32_t, 1>(i32));
+        const xt::xtensor<uint64_t, 1> u64 = {1, 1099511627776, 0};
+        REQUIRE(fmt_tensor<uint64_t, 1>(u64) == xio_tensor<uint64_t, 1>(u64));
+        // wrapped lines and the edge items of the big tensors
+        const hvector_t frates = xt::linspace<double>(60.0, 144.0, 29);
+        REQUIRE(fmt_tensor<double, 1>(frates) == xio_tensor<double, 1>(frates));
+        const hvector_t big = xt::arange<double>(0.0, 300.0, 0.25);
+        REQUIRE(fmt_tensor<double, 1>(big) == xio_tensor<double, 1>(big));
+        const harray2d_t verts = xt::ones<double>({2000, 2}) * 0.125;
+        REQUIRE(fmt_tensor<double, 2>(verts) == xio_tensor<double, 2>(verts));
+    }
+}
+
+//  Not run by default (hidden), run `hmdq_test "[!benchmark]"` to get the numbers.
+TEST_CASE("Tensor formatter benchmark", "[.][!benchmark][xtdef]")
+{
+    const xt::xtensor<double, 3> m34 = xt::ones<double>({16, 3, 4}) * 0.0321;
+
+    BENCHMARK("xio")
+    {
+        return xio_tensor<double, 3>(m34).size();
+    };
+
+    BENCHMARK("format_tensor")
+    {
+        return fmt_tensor<double, 3>(m34).size();
+    };
+}
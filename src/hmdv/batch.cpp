@@ -0,0 +1,354 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#include "hmdv_misc.h"
+
+#include <common/archive.h>
+#include <common/base_classes.h>
+#include <common/config.h>
+#include <common/except.h>
+#include <common/fmthlp.h>
+#include <common/jkeys.h>
+#include <common/jtools.h>
+#include <common/oculus_processor.h>
+#include <common/openvr_common.h>
+#include <common/openvr_processor.h>
+#include <common/prtdata.h>
+#include <common/tpool.h>
+#include <common/wintools.h>
+#include <hmdv/batch.h>
+#include <hmdv/hmdfix.h>
+#include <hmdv/manifest.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <string_view>
+#include <system_error>
+
+//  locals
+//------------------------------------------------------------------------------
+//  data file extensions searched in the batch directory
+static constexpr std::array<std::string_view, 3> DATA_EXTS
+    = {".json", ".cbor", ".msgpack"};
+
+//  OpenVR HMD device index (vr::k_unTrackedDeviceIndex_Hmd)
+static constexpr const char* OVR_HMD_ID = "0";
+
+//  files queued ahead of the printing (per worker thread)
+static constexpr size_t FILES_AHEAD = 4;
+
+//  functions
+//------------------------------------------------------------------------------
+//  Return true if the path has a data file extension.
+static bool is_data_file(const std::filesystem::path& path)
+{
+    auto ext = path_to_utf8(path.extension());
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return std::find(DATA_EXTS.begin(), DATA_EXTS.end(), ext) != DATA_EXTS.end();
+}
+
+//  Match the name against the glob pattern (supports '*' and '?').
+static bool glob_match(std::string_view pattern, std::string_view name)
+{
+    size_t p = 0, n = 0;
+    // the last '*' position in the pattern and the name position it matched from
+    size_t star = std::string_view::npos, mark = 0;
+    while (n < name.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+            ++p;
+            ++n;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            mark = n;
+        } else if (star != std::string_view::npos) {
+            p = star + 1;
+            n = ++mark;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+//  Return the data files in the directory and all its subdirectories.
+static std::vector<std::filesystem::path> scan_dir(const std::filesystem::path& dir)
+{
+    std::vector<std::filesystem::path> res;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(dir)) {
+        if (entry.is_regular_file() && is_data_file(entry.path())) {
+            res.push_back(entry.path());
+        }
+    }
+    return res;
+}
+
+//  Return the files in the directory matching the glob pattern.
+static std::vector<std::filesystem::path> scan_glob(const std::filesystem::path& dir,
+                                                    const std::string& pattern)
+{
+    std::vector<std::filesystem::path> res;
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        if (entry.is_regular_file()
+            && glob_match(pattern, path_to_utf8(entry.path().filename()))) {
+            res.push_back(entry.path());
+        }
+    }
+    return res;
+}
+
+//  Return the file paths listed in the list file (one per line, '#' starts a comment).
+static std::vector<std::filesystem::path> read_list(const std::filesystem::path& list)
+{
+    std::vector<std::filesystem::path> res;
+    std::ifstream lin(list);
+    for (std::string line; std::getline(lin, line);) {
+        const auto first = line.find_first_not_of(" \t");
+        const auto last = line.find_last_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+        res.push_back(utf8_to_path(line.substr(first, last - first + 1)));
+    }
+    return res;
+}
+
+//  Return the file paths given by the batch input.
+std::vector<std::filesystem::path> collect_batch_files(const std::filesystem::path& input)
+{
+    std::vector<std::filesystem::path> res;
+    std::filesystem::path apath;
+    std::string selector;
+    if (split_archive_path(input, apath, selector)) {
+        const auto parc = open_archive(apath);
+        for (const auto i : parc->select(selector)) {
+            res.push_back(archive_entry_path(apath, i));
+        }
+        return res;
+    }
+    const auto fname = path_to_utf8(input.filename());
+    if (std::filesystem::is_directory(input)) {
+        res = scan_dir(input);
+    } else if (fname.find_first_of("*?") != std::string::npos) {
+        const auto dir = input.has_parent_path() ? input.parent_path()
+                                                 : std::filesystem::path(".");
+        res = scan_glob(dir, fname);
+    } else if (std::filesystem::is_regular_file(input)) {
+        if (is_data_file(input)) {
+            return {input};
+        }
+        return read_list(input);
+    } else {
+        throw hmdq_error(fmt::format("Cannot find batch input: {}", path_to_utf8(input)));
+    }
+    // directory iteration order is unspecified
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
+//  Return the archive of the batch input, or nullptr if the input is not an archive.
+std::shared_ptr<const Archive> open_batch_archive(const std::filesystem::path& input)
+{
+    std::filesystem::path apath;
+    std::string selector;
+    if (split_archive_path(input, apath, selector)) {
+        return open_archive(apath);
+    }
+    return nullptr;
+}
+
+//  Return the file stamp, or none if the file cannot be checked.
+std::optional<FileStamp> get_file_stamp(const std::filesystem::path& fpath)
+{
+    std::error_code ec;
+    FileStamp stamp;
+    stamp.size = std::filesystem::file_size(fpath, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    stamp.mtime = static_cast<int64_t>(
+        std::filesystem::last_write_time(fpath, ec).time_since_epoch().count());
+    if (ec) {
+        return std::nullopt;
+    }
+    return stamp;
+}
+
+//  Return the HMD property from the OpenVR or Oculus properties.
+std::string get_hmd_prop(const json& jd, const char* ovr_prop, const char* ocl_prop)
+{
+    const auto root = json::json_pointer();
+    // top level properties are the old (pre v1.3.4) layout
+    const std::array<json::json_pointer, 3> ptrs
+        = {root / j_openvr / j_properties / OVR_HMD_ID / ovr_prop,
+           root / j_properties / OVR_HMD_ID / ovr_prop,
+           root / j_oculus / j_properties / j_hmd / ocl_prop};
+    for (const auto& ptr : ptrs) {
+        if (jd.contains(ptr) && jd.at(ptr).is_string()) {
+            return jd.at(ptr).get<std::string>();
+        }
+    }
+    return {};
+}
+
+//  Return the data file sections needed by `get_hmd_prop`.
+std::vector<std::string> hmd_prop_sections()
+{
+    return {fmt::format("/{}/{}/{}", j_openvr, j_properties, OVR_HMD_ID),
+            fmt::format("/{}/{}", j_properties, OVR_HMD_ID),
+            fmt::format("/{}/{}/{}", j_oculus, j_properties, j_hmd)};
+}
+
+//  Verify, fix and recalculate one data file.
+BatchResult process_one_file(const std::filesystem::path& in_json,
+                             const std::shared_ptr<json>& pjapi, ThreadPool& pool)
+{
+    BatchResult res{in_json};
+    // take the stamp before reading, so a change made meanwhile is caught next time
+    res.stamp = get_file_stamp(in_json);
+    try {
+        auto jd = read_json(in_json);
+        const auto check_ok = verify_checksum(jd);
+        res.fixed = apply_all_relevant_fixes(jd);
+
+        procmap_t processors;
+        if (jd.contains(j_openvr)) {
+            auto openvr_processor = std::make_shared<openvr::Processor>(
+                pjapi, std::make_shared<json>(std::move(jd[j_openvr])));
+            processors.emplace(openvr_processor->get_id(), openvr_processor);
+        }
+        if (jd.contains(j_oculus)) {
+            auto oculus_processor = std::make_shared<oculus::Processor>(
+                std::make_shared<json>(std::move(jd[j_oculus])));
+            processors.emplace(oculus_processor->get_id(), oculus_processor);
+        }
+        // the subsystems are independent, calculate them as separate tasks
+        std::vector<std::future<void>> tasks;
+        for (auto& [proc_id, proc] : processors) {
+            auto pproc = proc.get();
+            tasks.push_back(pool.submit([pproc, &pool]() {
+                pproc->init();
+                pproc->calculate(pool, 0);
+            }));
+        }
+        pool.wait_all(tasks);
+        res.status = check_ok ? bstatus::ok : bstatus::invalid;
+    } catch (const std::exception& e) {
+        res.status = bstatus::error;
+        res.msg = e.what();
+    }
+    return res;
+}
+
+//  Print the result of one data file.
+static void print_result(const BatchResult& res, int ind, int ts)
+{
+    const auto sf = ind * ts;
+    const auto fpath = path_to_utf8(res.path);
+    const auto fixed = res.fixed ? " (fixed)" : "";
+    const auto cached = res.cached ? " (cached)" : "";
+    switch (res.status) {
+        case bstatus::ok:
+            iprint(sf, "[OK] {}{}{}\n", fpath, fixed, cached);
+            break;
+        case bstatus::invalid:
+            iprint(sf, "[Invalid] {}{}{}\n", fpath, fixed, cached);
+            break;
+        case bstatus::error:
+            iprint(sf, "[Error] {}: {}\n", fpath, res.msg);
+            break;
+    }
+}
+
+//  Process all data files from the batch input.
+int run_batch(const std::filesystem::path& api_json, const std::filesystem::path& input,
+              const std::filesystem::path& manifest, int jobs, int verb, int ind, int ts)
+{
+    const auto sf = ind * ts;
+    const auto vdef = g_cfgs.verb.def;
+    const auto start = std::chrono::steady_clock::now();
+
+    // print the execution header
+    print_header(HMDV_NAME, HMDV_VERSION, HMDV_DESCRIPTION, verb, ind, ts);
+    if (verb >= vdef)
+        oprint("\n");
+
+    // keep the input archive open for the whole run, the entries are read from it
+    const auto parc = open_batch_archive(input);
+    const auto files = collect_batch_files(input);
+    // load the OpenVR API definition only once for all files
+    const auto pjapi = std::make_shared<json>(openvr::load_json_oapi(api_json));
+    // the manifest is only read by the workers, the results are recorded at the end
+    BatchManifest bmf;
+    if (!manifest.empty() && std::filesystem::exists(manifest)) {
+        bmf = BatchManifest(manifest);
+    }
+
+    ThreadPool pool(jobs >= 0 ? jobs : 0);
+
+    // only a few files are in flight at a time, the results are printed in the input
+    // order as they come
+    std::vector<BatchResult> results;
+    results.reserve(files.size());
+    std::array<size_t, 3> counts{};
+    size_t cached = 0;
+    std::deque<std::future<BatchResult>> pending;
+    const auto ahead = pool.size() * FILES_AHEAD;
+    auto next = files.cbegin();
+    while (next != files.cend() || !pending.empty()) {
+        for (; next != files.cend() && pending.size() < ahead; ++next) {
+            const auto& fpath = *next;
+            pending.push_back(pool.submit([&fpath, &pjapi, &bmf, &pool]() {
+                if (auto res = bmf.find(fpath)) {
+                    return *res;
+                }
+                return process_one_file(fpath, pjapi, pool);
+            }));
+        }
+        const auto& res = results.emplace_back(pending.front().get());
+        pending.pop_front();
+        ++counts[static_cast<size_t>(res.status)];
+        cached += res.cached ? 1 : 0;
+        if (verb >= vdef || res.status == bstatus::error) {
+            print_result(res, ind, ts);
+        }
+    }
+
+    if (!manifest.empty()) {
+        for (const auto& res : results) {
+            bmf.update(res);
+        }
+        bmf.save(manifest);
+    }
+
+    if (verb >= vdef) {
+        const std::chrono::duration<double> elapsed
+            = std::chrono::steady_clock::now() - start;
+        oprint("\n");
+        iprint(sf, "Processed {} files ({} cached) in {:.1f} s on {} threads: {} OK, {} "
+                   "invalid, {} failed\n",
+               files.size(), cached, elapsed.count(), pool.size(),
+               counts[static_cast<size_t>(bstatus::ok)],
+               counts[static_cast<size_t>(bstatus::invalid)],
+               counts[static_cast<size_t>(bstatus::error)]);
+    }
+    return counts[static_cast<size_t>(bstatus::ok)] == files.size() ? 0 : 1;
+}
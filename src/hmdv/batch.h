@@ -0,0 +1,89 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <common/json_proxy.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+class Archive;
+class ThreadPool;
+
+//  typedefs
+//------------------------------------------------------------------------------
+//  Batch processing status of one data file
+enum class bstatus { ok, invalid, error };
+
+//  Data file size and modification time (as the file clock ticks)
+struct FileStamp {
+    uintmax_t size = 0;
+    int64_t mtime = 0;
+};
+
+//  Batch processing result of one data file
+struct BatchResult {
+    std::filesystem::path path;
+    bstatus status = bstatus::error;
+    // some fixes were applied
+    bool fixed = false;
+    // error message (if the processing failed)
+    std::string msg;
+    // file stamp taken before the file was read (none if the file could not be
+    // checked, e.g. an archive entry)
+    std::optional<FileStamp> stamp;
+    // the result was taken from the batch manifest
+    bool cached = false;
+};
+
+//  functions
+//------------------------------------------------------------------------------
+//  Return the data files given by the batch input, which is either a directory
+//  (searched recursively), a glob pattern (e.g. "dumps/*.json"), a single data file, a
+//  list file with one data file path per line, or an archive (with an optional entry
+//  selector, e.g. "corpus.hmdqa#model=Index").
+std::vector<std::filesystem::path>
+collect_batch_files(const std::filesystem::path& input);
+
+//  Return the archive of the batch input, or nullptr if the input is not an archive.
+//  The runner holds it for the whole run, so all entries are read from the one open
+//  archive.
+std::shared_ptr<const Archive> open_batch_archive(const std::filesystem::path& input);
+
+//  Return the file stamp, or none if the file cannot be checked.
+std::optional<FileStamp> get_file_stamp(const std::filesystem::path& fpath);
+
+//  Return the HMD property (e.g. the model name) from the OpenVR HMD device properties
+//  (`ovr_prop`), or the Oculus HMD properties (`ocl_prop`), or an empty string if there
+//  is none. Both the current and the old (pre v1.3.4) OpenVR layout are accepted.
+std::string get_hmd_prop(const json& jd, const char* ovr_prop, const char* ocl_prop);
+
+//  Return the data file sections (for `read_json_sections`) needed by `get_hmd_prop`.
+std::vector<std::string> hmd_prop_sections();
+
+//  Verify the checksum, apply all fixes and recalculate the geometry of one data file.
+//  The OpenVR API definition `pjapi` is shared by all files, the independent geometry
+//  calculations (each geometry block and each eye) run as separate tasks in the pool.
+BatchResult process_one_file(const std::filesystem::path& in_json,
+                             const std::shared_ptr<json>& pjapi, ThreadPool& pool);
+
+//  Process all data files from the batch input on `jobs` worker threads (0 = one per
+//  hardware thread), print the result of each file and the summary. If the `manifest`
+//  file is given, the recorded results of the unchanged files are reused and the new
+//  results are recorded there. Return 0 if all files were processed and their
+//  checksums were valid.
+int run_batch(const std::filesystem::path& api_json, const std::filesystem::path& input,
+              const std::filesystem::path& manifest, int jobs, int verb, int ind, int ts);
@@ -13,6 +13,7 @@
 
 #include <common/calcview.h>
 #include <common/except.h>
+#include <common/geom.h>
 #include <common/jkeys.h>
 #include <common/json_proxy.h>
 #include <common/jtools.h>
@@ -21,14 +22,16 @@
 #include <fmt/chrono.h>
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
+#include <limits>
 #include <string>
 
 //  locals
 //------------------------------------------------------------------------------
 //  miscellanous section keys
 static constexpr auto MM_IN_METER = 1000;
-// static constexpr double HAM_AREA_ROUNDOFF = 0.00001;
 static constexpr double HAM_AREA_ROUNDOFF = std::numeric_limits<double>::epsilon();
 
 //  fix identifications
@@ -178,6 +181,16 @@ void fix_fov_algo(json& jd)
     }
 }
 
+//  Return true if the stored HAM area differs from the recalculated one only by the
+//  roundoff (the stored one may come from GEOS, see HAM_AREA_ALGO_TOLERANCE).
+static bool same_ham_area(double stored, double calc)
+{
+    const auto tol
+        = std::max(HAM_AREA_ROUNDOFF, HAM_AREA_ALGO_TOLERANCE * std::abs(stored));
+    return std::abs(calc - stored) < tol;
+}
+
+//  Recalculate the HAM area with the native clipper (keep the matching stored area).
 bool fix_ham_area_algo(json& jd)
 {
     auto geoms = collect_geoms(jd);
@@ -190,8 +203,7 @@ bool fix_ham_area_algo(json& jd)
                     auto& ham_eye = ham_mesh[neye];
                     auto ham_area = calc_ham_area(ham_eye);
                     if (!ham_eye.contains(j_ham_area)
-                        || std::abs(ham_area - ham_eye[j_ham_area].get<double>())
-                            >= HAM_AREA_ROUNDOFF) {
+                        || !same_ham_area(ham_eye[j_ham_area].get<double>(), ham_area)) {
                         ham_eye[j_ham_area] = ham_area;
                         fixed = true;
                     }
@@ -13,7 +13,12 @@
 
 #include <common/json_proxy.h>
 
+#include <vector>
+
 //  functions
 //------------------------------------------------------------------------------
+//  Return the valid geometry sections (OpenVR, Oculus default and max FOV)
+std::vector<json*> collect_geoms(json& jd);
+
 //  Check and run all fixes (return true if there was any)
 bool apply_all_relevant_fixes(json& jd);
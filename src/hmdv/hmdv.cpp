@@ -26,7 +26,10 @@
 #include <common/openvr_processor.h>
 #include <common/prtdata.h>
 #include <common/wintools.h>
+#include <hmdv/batch.h>
 #include <hmdv/hmdfix.h>
+#include <hmdv/pack.h>
+#include <hmdv/stats.h>
 
 #include <clipp/clipp.h>
 
@@ -45,6 +48,8 @@
 #include <ctime>
 #include <filesystem>
 #include <fstream>
+#include <string>
+#include <vector>
 
 //  defines
 //------------------------------------------------------------------------------
@@ -54,16 +59,31 @@
 //  typedefs
 //------------------------------------------------------------------------------
 //  mode of operation
-enum class mode { geom, props, all, verify, info, help };
+enum class mode { geom, props, all, verify, batch, stats, pack, unpack, info, help };
 
 //  locals
 //------------------------------------------------------------------------------
 static constexpr int IND = 0;
 static constexpr unsigned int CP_UTF8 = 65001;
-const auto OPENVR_API_JSON = "openvr_api.json";
 
 //  functions
 //------------------------------------------------------------------------------
+//  Return JSON pointers to the sections needed for printing the geometry only.
+static std::vector<std::string> geom_sections()
+{
+    // top level sections are the old (pre v1.3.4) layout, the fixes applied after
+    // loading move all of them into the OpenVR section
+    std::vector<std::string> res
+        = {fmt::format("/{}", j_misc), fmt::format("/{}", j_devices),
+           fmt::format("/{}", j_properties), fmt::format("/{}", j_geometry)};
+    for (const auto& proc_id : {j_openvr, j_oculus}) {
+        for (const auto& key : {ERROR_PREFIX, j_rt_path, j_rt_ver, j_geometry}) {
+            res.push_back(fmt::format("/{}/{}", proc_id, key));
+        }
+    }
+    return res;
+}
+
 //  Print version and other usefull info.
 void print_info(int ind = 0, int ts = 0)
 {
@@ -123,18 +143,16 @@ static pmode mode2pmode(const mode selected)
 int run_verify(const std::filesystem::path& in_json, int verb, int ind, int ts)
 {
     const auto sf = ind * ts;
-    const auto vdef = g_cfg[j_verbosity][j_default].get<int>();
+    const auto vdef = g_cfgs.verb.def;
 
     // print the execution header
     print_header(HMDV_NAME, HMDV_VERSION, HMDV_DESCRIPTION, verb, ind, ts);
     if (verb >= vdef)
         fmt::print("\n");
 
-    // read JSON data input
-    json out = read_json(in_json);
-
-    // verify the checksum
-    auto check_ok = verify_checksum(out);
+    // verify the checksum (no need to keep any data)
+    bool check_ok = false;
+    read_json_sections(in_json, {}, &check_ok);
     if (verb >= vdef) {
         if (check_ok) {
             iprint(sf, "[OK] {}\n", path_to_utf8(in_json));
@@ -148,23 +166,30 @@ int run_verify(const std::filesystem::path& in_json, int verb, int ind, int ts)
 //  main runner
 int run(const print_options& opts, const std::filesystem::path& api_json,
         const std::filesystem::path& in_json, const std::filesystem::path& out_json,
-        int ind, int ts)
+        const std::string& out_format, int ind, int ts)
 {
     const auto sf = ind * ts;
+    // check the output format before doing anything
+    const auto format = get_jformat(out_format);
     // initialize config values
-    const auto json_indent = g_cfg[j_format][j_json_indent].get<int>();
-    const auto vdef = g_cfg[j_verbosity][j_default].get<int>();
+    const auto json_indent = g_cfgs.json_indent;
+    const auto vdef = g_cfgs.verb.def;
 
     // print the execution header
     print_header(HMDV_NAME, HMDV_VERSION, HMDV_DESCRIPTION, opts.verbosity, ind, ts);
     if (opts.verbosity >= vdef)
         fmt::print("\n");
 
-    // read JSON data input
-    json out = read_json(in_json);
-
-    // verify the checksum
-    auto check_ok = verify_checksum(out);
+    // read JSON data input and verify the checksum, if only the geometry is printed,
+    // load only the relevant sections
+    json out;
+    bool check_ok = false;
+    if (opts.mode == pmode::geom && out_json.empty()) {
+        out = read_json_sections(in_json, geom_sections(), &check_ok);
+    } else {
+        out = read_json(in_json);
+        check_ok = verify_checksum(out);
+    }
     if (!check_ok && opts.verbosity >= vdef) {
         iprint(sf, "Warning: Input file checksum is invalid\n\n");
     }
@@ -209,12 +234,9 @@ int run(const print_options& opts, const std::filesystem::path& api_json,
     // dump the data into the optional JSON file
     if (!out_json.empty()) {
         out.erase(j_checksum);
-        // add the checksum only if the original file was authentic
-        if (check_ok) {
-            add_checksum(out);
-        }
-        // save the JSON file with indentation
-        write_json(out_json, out, json_indent);
+        // save the JSON file with indentation (or in the binary format), add the
+        // checksum only if the original file was authentic
+        write_json(out_json, out, json_indent, format, check_ok);
     }
     return 0;
 }
@@ -242,7 +264,6 @@ int run_wrapper(F func, Args&&... args)
 int main(int argc, char* argv[])
 {
     using namespace clipp;
-    const auto OPENVR_API_JSON = "openvr_api.json";
 
     // Set UTF-8 code page for the console if available
     // if not, print UTF-8 strings to the console anyway.
@@ -267,31 +288,46 @@ int main(int argc, char* argv[])
     if (!cfg_ok)
         return 1;
 
-    const auto ts = g_cfg[j_format][j_cli_indent].get<int>();
+    const auto ts = g_cfgs.cli_indent;
     const auto ind = IND;
 
     print_options opts;
 
     // defaults for the arguments
-    opts.verbosity = g_cfg[j_verbosity][j_default].get<int>();
-    opts.anonymize = g_cfg[j_control][j_anonymize].get<bool>();
+    opts.verbosity = g_cfgs.verb.def;
+    opts.anonymize = g_cfgs.anonymize;
 
     // default command is 'all'
     mode cmd = mode::all;
 
-    // build relative path to OPENVR_API_JSON file
-    std::filesystem::path api_json_path = get_full_prog_path();
-    api_json_path.replace_filename(OPENVR_API_JSON);
-    auto api_json = path_to_utf8(api_json_path);
+    // OpenVR API definition is built in, the file is only an (optional) override
+    std::string api_json;
 
     std::string out_json;
+    std::string out_format = "json";
     std::string in_json;
+    // batch input and the number of worker threads (0 = one per hardware thread)
+    std::string batch_in;
+    std::string manifest;
+    int jobs = 0;
+    // stats output file and format
+    std::string stats_out;
+    std::string stats_format = "csv";
+    // archive (with the entry selector for unpack) and the output directory
+    std::string archive;
+    std::string out_dir = ".";
+    bool list_only = false;
     // custom help texts
     const auto verb_help = fmt::format("verbosity level [{}]", opts.verbosity);
-    const auto api_json_help
-        = fmt::format("OpenVR API JSON definition file [\"{}\"]", api_json);
+    const auto api_json_help = std::string("OpenVR API JSON definition file [built-in]");
     const auto anon_help
         = fmt::format("anonymize serial numbers in the output [{}]", opts.anonymize);
+    const auto format_help
+        = fmt::format("output file format (json, cbor, msgpack) [{}]", out_format);
+    const auto jobs_help
+        = fmt::format("number of worker threads (0 = one per CPU core) [{}]", jobs);
+    const auto stats_format_help
+        = fmt::format("stats output format (csv, json) [{}]", stats_format);
 
     // Use this construct to accept an "empty" command. First parse all together
     // (cli_cmds, cli_args, cli_opts) then (cli_args, cli_opts) to accept also only the
@@ -300,6 +336,7 @@ int main(int argc, char* argv[])
     auto cli_opts
         = ((option("-a", "--api_json") & value("name", api_json)) % api_json_help,
            (option("-o", "--out_json") & value("name", out_json)) % "JSON output file",
+           (option("-f", "--format") & value("name", out_format)) % format_help,
            (option("-v", "--verb").set(opts.verbosity, 1)
             & opt_value("level", opts.verbosity))
                % verb_help,
@@ -311,6 +348,44 @@ int main(int argc, char* argv[])
            (option("--ovr_max_fov").set(opts.ovr_max_fov, true)
             % "show also Oculus max FOV data"));
 
+    auto cli_batch
+        = ((option("-j", "--jobs") & value("num", jobs)) % jobs_help,
+           (option("-m", "--manifest") & value("name", manifest))
+               % "batch manifest file (reuse the results of unchanged files)",
+           (option("-a", "--api_json") & value("name", api_json)) % api_json_help,
+           (option("-v", "--verb").set(opts.verbosity, 1)
+            & opt_value("level", opts.verbosity))
+               % verb_help,
+           value("input", batch_in) % "data directory, glob pattern or list file");
+
+    auto cli_stats
+        = ((option("-j", "--jobs") & value("num", jobs)) % jobs_help,
+           (option("-o", "--out") & value("name", stats_out))
+               % "stats output file [standard output]",
+           (option("-f", "--format") & value("name", stats_format)) % stats_format_help,
+           (option("-v", "--verb").set(opts.verbosity, 1)
+            & opt_value("level", opts.verbosity))
+               % verb_help,
+           value("input", batch_in) % "data directory, glob pattern or list file");
+
+    auto cli_pack = ((option("-v", "--verb").set(opts.verbosity, 1)
+                      & opt_value("level", opts.verbosity))
+                         % verb_help,
+                     value("archive", archive) % "archive file (created if needed)",
+                     value("input", batch_in)
+                         % "data directory, glob pattern, list file or archive");
+
+    auto cli_unpack
+        = ((option("-d", "--dir") & value("name", out_dir))
+               % fmt::format("output directory [{}]", out_dir),
+           option("-l", "--list").set(list_only) % "only list the entries",
+           (option("-v", "--verb").set(opts.verbosity, 1)
+            & opt_value("level", opts.verbosity))
+               % verb_help,
+           value("archive", archive)
+               % "archive file with an optional entry selector (<archive>#<index> or "
+                 "<archive>#<key>=<value>,...)");
+
     auto cli_nocmd = (cli_opts, cli_args);
     auto cli_cmds
         = ((command("geom").set(cmd, mode::geom).doc("show only geometry data")
@@ -325,6 +400,22 @@ int main(int argc, char* argv[])
                   .set(cmd, mode::verify)
                   .doc("verify the data file integrity"),
               cli_args)
+           | (command("batch")
+                  .set(cmd, mode::batch)
+                  .doc("verify, fix and recalculate multiple data files"),
+              cli_batch)
+           | (command("stats")
+                  .set(cmd, mode::stats)
+                  .doc("show geometry statistics of multiple data files"),
+              cli_stats)
+           | (command("pack")
+                  .set(cmd, mode::pack)
+                  .doc("append data files to the archive"),
+              cli_pack)
+           | (command("unpack")
+                  .set(cmd, mode::unpack)
+                  .doc("extract (or list) the archive entries"),
+              cli_unpack)
            | command("version").set(cmd, mode::info).doc("show version and other info")
            | command("help").set(cmd, mode::help).doc("show this help page"));
 
@@ -342,12 +433,32 @@ int main(int argc, char* argv[])
             case mode::all:
                 opts.mode = mode2pmode(cmd);
                 res = run_wrapper(run, opts, utf8_to_path(api_json),
-                                  utf8_to_path(in_json), utf8_to_path(out_json), ind, ts);
+                                  utf8_to_path(in_json), utf8_to_path(out_json),
+                                  out_format, ind, ts);
                 break;
             case mode::verify:
                 res = run_wrapper(run_verify, utf8_to_path(in_json), opts.verbosity, ind,
                                   ts);
                 break;
+            case mode::batch:
+                res = run_wrapper(run_batch, utf8_to_path(api_json),
+                                  utf8_to_path(batch_in), utf8_to_path(manifest), jobs,
+                                  opts.verbosity, ind, ts);
+                break;
+            case mode::stats:
+                res = run_wrapper(run_stats, utf8_to_path(batch_in),
+                                  utf8_to_path(stats_out), stats_format, jobs,
+                                  opts.verbosity, ind, ts);
+                break;
+            case mode::pack:
+                res = run_wrapper(run_pack, utf8_to_path(archive), utf8_to_path(batch_in),
+                                  opts.verbosity, ind, ts);
+                break;
+            case mode::unpack:
+                res = run_wrapper(run_unpack, utf8_to_path(archive),
+                                  utf8_to_path(out_dir), list_only, opts.verbosity, ind,
+                                  ts);
+                break;
             case mode::help:
                 fmt::print("Usage:\n{:s}\nOptions:\n{:s}\n",
                            usage_lines(cli, HMDV_NAME).str(), documentation(cli).str());
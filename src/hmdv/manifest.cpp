@@ -0,0 +1,137 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#include "hmdv_misc.h"
+
+#include <common/config.h>
+#include <common/jkeys.h>
+#include <common/jtools.h>
+#include <common/wintools.h>
+#include <hmdv/manifest.h>
+
+#include <algorithm>
+#include <vector>
+
+//  locals
+//------------------------------------------------------------------------------
+//  manifest keys
+static constexpr const char* MF_FILES = "files";
+static constexpr const char* MF_PATH = "path";
+static constexpr const char* MF_SIZE = "size";
+static constexpr const char* MF_MTIME = "mtime";
+static constexpr const char* MF_STATUS = "status";
+static constexpr const char* MF_FIXED = "fixed";
+
+//  functions
+//------------------------------------------------------------------------------
+//  Return the manifest key of the file (its absolute path).
+static std::string file_key(const std::filesystem::path& fpath)
+{
+    return path_to_utf8(std::filesystem::absolute(fpath).lexically_normal());
+}
+
+static const char* status_name(bstatus status)
+{
+    switch (status) {
+        case bstatus::ok:
+            return "ok";
+        case bstatus::invalid:
+            return "invalid";
+        default:
+            return "error";
+    }
+}
+
+static bstatus status_from_name(const std::string& name)
+{
+    if (name == "ok") {
+        return bstatus::ok;
+    } else if (name == "invalid") {
+        return bstatus::invalid;
+    }
+    return bstatus::error;
+}
+
+//  BatchManifest class
+//------------------------------------------------------------------------------
+BatchManifest::BatchManifest(const std::filesystem::path& mpath)
+{
+    const auto jd = read_json(mpath);
+    if (jd.value(j_hmdv_ver, "") != HMDV_VERSION) {
+        return;
+    }
+    for (const auto& jentry : jd[MF_FILES]) {
+        Entry entry;
+        entry.stamp.size = jentry[MF_SIZE].get<uintmax_t>();
+        entry.stamp.mtime = jentry[MF_MTIME].get<int64_t>();
+        entry.status = status_from_name(jentry[MF_STATUS].get<std::string>());
+        entry.fixed = jentry[MF_FIXED].get<bool>();
+        m_entries.insert_or_assign(jentry[MF_PATH].get<std::string>(), std::move(entry));
+    }
+}
+
+//  Return the recorded result of the file if it can be reused.
+std::optional<BatchResult> BatchManifest::find(const std::filesystem::path& fpath) const
+{
+    const auto it = m_entries.find(file_key(fpath));
+    if (it == m_entries.end()) {
+        return std::nullopt;
+    }
+    const auto& entry = it->second;
+    // any change of the modification time means the file may have changed
+    const auto stamp = get_file_stamp(fpath);
+    if (!stamp || stamp->size != entry.stamp.size || stamp->mtime != entry.stamp.mtime) {
+        return std::nullopt;
+    }
+    BatchResult res{fpath, entry.status, entry.fixed};
+    res.stamp = stamp;
+    res.cached = true;
+    return res;
+}
+
+//  Record the result of the file.
+void BatchManifest::update(const BatchResult& res)
+{
+    const auto key = file_key(res.path);
+    if (res.status == bstatus::error || !res.stamp) {
+        m_entries.erase(key);
+        return;
+    }
+    m_entries.insert_or_assign(key, Entry{*res.stamp, res.status, res.fixed});
+}
+
+//  Save the manifest into the file.
+void BatchManifest::save(const std::filesystem::path& mpath) const
+{
+    // save the entries sorted by the path
+    std::vector<const std::pair<const std::string, Entry>*> items;
+    items.reserve(m_entries.size());
+    for (const auto& item : m_entries) {
+        items.push_back(&item);
+    }
+    std::sort(items.begin(), items.end(),
+              [](const auto* a, const auto* b) { return a->first < b->first; });
+
+    // (ordered) json object would make the insertion quadratic, use the array instead
+    json jfiles = json::array();
+    for (const auto* item : items) {
+        const auto& [path, entry] = *item;
+        jfiles.push_back({{MF_PATH, path},
+                          {MF_SIZE, entry.stamp.size},
+                          {MF_MTIME, entry.stamp.mtime},
+                          {MF_STATUS, status_name(entry.status)},
+                          {MF_FIXED, entry.fixed}});
+    }
+    json jd;
+    jd[j_hmdv_ver] = HMDV_VERSION;
+    jd[MF_FILES] = std::move(jfiles);
+    write_json(mpath, jd, g_cfgs.json_indent);
+}
@@ -0,0 +1,54 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <hmdv/batch.h>
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+//  Batch manifest keeps the results of the processed data files. The result is reused
+//  if the file has not changed since (it has the same size and modification time) and
+//  was processed by the same hmdv version. The failed files are not recorded, so they
+//  are processed again in the next run.
+class BatchManifest
+{
+  public:
+    BatchManifest() = default;
+    //  Load the manifest from the file, the results recorded by a different hmdv
+    //  version are dropped.
+    explicit BatchManifest(const std::filesystem::path& mpath);
+
+  public:
+    //  Return the recorded result of the file if it can be reused. It is safe to call
+    //  from multiple threads while the manifest is not updated.
+    std::optional<BatchResult> find(const std::filesystem::path& fpath) const;
+
+    //  Record the result of the file with the file stamp taken before it was processed
+    //  (the result without the stamp is dropped).
+    void update(const BatchResult& res);
+
+    //  Save the manifest into the file.
+    void save(const std::filesystem::path& mpath) const;
+
+  private:
+    //  Recorded file result
+    struct Entry {
+        FileStamp stamp;
+        bstatus status = bstatus::error;
+        bool fixed = false;
+    };
+
+    std::unordered_map<std::string, Entry> m_entries;
+};
@@ -0,0 +1,232 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#include "hmdv_misc.h"
+
+#include <common/archive.h>
+#include <common/config.h>
+#include <common/except.h>
+#include <common/fmthlp.h>
+#include <common/jkeys.h>
+#include <common/jtools.h>
+#include <common/oculus_props.h>
+#include <common/prtdata.h>
+#include <common/wintools.h>
+#include <hmdv/batch.h>
+#include <hmdv/pack.h>
+
+#include <fmt/format.h>
+
+#include <fstream>
+#include <unordered_set>
+
+//  locals
+//------------------------------------------------------------------------------
+//  archive entry metadata keys (besides hmdq_ver, checksum and time)
+static constexpr const char* AR_NAME = "name";
+static constexpr const char* AR_MODEL = "model";
+static constexpr const char* AR_MANUFACTURER = "manufacturer";
+
+//  OpenVR HMD model and manufacturer properties
+static constexpr const char* OVR_MODEL_PROP = "Prop_ModelNumber_String";
+static constexpr const char* OVR_MANUFACTURER_PROP = "Prop_ManufacturerName_String";
+
+//  functions
+//------------------------------------------------------------------------------
+//  Return the string at `ptr` (or an empty string if there is none).
+static std::string get_string(const json& jd, const json::json_pointer& ptr)
+{
+    if (jd.contains(ptr) && jd.at(ptr).is_string()) {
+        return jd.at(ptr).get<std::string>();
+    }
+    return {};
+}
+
+//  Return the archive entry metadata of the data file.
+static json entry_meta(const std::filesystem::path& fpath)
+{
+    // the entry from another archive keeps its metadata
+    std::filesystem::path apath;
+    std::string selector;
+    if (split_archive_path(fpath, apath, selector)) {
+        const auto parc = open_archive(apath);
+        return parc->meta(parc->select_one(selector));
+    }
+
+    auto sections = hmd_prop_sections();
+    sections.insert(sections.end(),
+                    {fmt::format("/{}", j_misc), fmt::format("/{}", j_checksum)});
+    const auto jd = read_json_sections(fpath, sections);
+    if (!jd.contains(j_misc)) {
+        throw hmdq_error("Not a data file (no misc section)");
+    }
+    const auto root = json::json_pointer();
+    json res;
+    res[AR_NAME] = path_to_utf8(fpath.filename());
+    res[AR_MODEL] = get_hmd_prop(jd, OVR_MODEL_PROP, oculus::Prop::ProductName_String);
+    res[AR_MANUFACTURER]
+        = get_hmd_prop(jd, OVR_MANUFACTURER_PROP, oculus::Prop::Manufacturer_String);
+    res[j_hmdq_ver] = get_string(jd, root / j_misc / j_hmdq_ver);
+    res[j_checksum] = get_string(jd, root / j_checksum);
+    res[j_time] = get_string(jd, root / j_misc / j_time);
+    return res;
+}
+
+//  Append the data files to the archive.
+int run_pack(const std::filesystem::path& archive, const std::filesystem::path& input,
+             int verb, int ind, int ts)
+{
+    const auto sf = ind * ts;
+    const auto vdef = g_cfgs.verb.def;
+
+    // print the execution header
+    print_header(HMDV_NAME, HMDV_VERSION, HMDV_DESCRIPTION, verb, ind, ts);
+    if (verb >= vdef)
+        oprint("\n");
+
+    std::filesystem::path apath;
+    std::string selector;
+    if (std::filesystem::exists(archive) && split_archive_path(input, apath, selector)
+        && std::filesystem::equivalent(apath, archive)) {
+        throw hmdq_error("Cannot pack the archive into itself");
+    }
+    // keep the input archive open for the whole run, the entries are read from it
+    const auto parc = open_batch_archive(input);
+    const auto files = collect_batch_files(input);
+
+    // the checksums of the archived files (to skip the duplicates)
+    std::unordered_set<std::string> checksums;
+    if (std::filesystem::exists(archive)) {
+        const Archive arc(archive);
+        for (size_t i = 0; i < arc.size(); ++i) {
+            const auto chksm = arc.meta(i).value(j_checksum, "");
+            if (!chksm.empty()) {
+                checksums.insert(chksm);
+            }
+        }
+    }
+
+    ArchiveWriter writer(archive);
+    size_t added = 0, skipped = 0, failed = 0;
+    for (const auto& fpath : files) {
+        const auto u8path = path_to_utf8(fpath);
+        try {
+            const auto meta = entry_meta(fpath);
+            const auto chksm = meta.value(j_checksum, "");
+            if (!chksm.empty() && !checksums.insert(chksm).second) {
+                ++skipped;
+                if (verb >= vdef) {
+                    iprint(sf, "[Skipped] {} (already in the archive)\n", u8path);
+                }
+                continue;
+            }
+            const auto data = read_data(fpath);
+            writer.append(meta, data.data(), data.data() + data.size());
+            ++added;
+            if (verb >= vdef) {
+                iprint(sf, "[Added] {} -> #{}\n", u8path, writer.size() - 1);
+            }
+        } catch (const std::exception& e) {
+            ++failed;
+            iprint(sf, "[Error] {}: {}\n", u8path, e.what());
+        }
+    }
+    writer.commit();
+
+    if (verb >= vdef) {
+        oprint("\n");
+        iprint(sf,
+               "Packed {} files into {} ({} entries): {} added, {} skipped, {} failed\n",
+               files.size(), path_to_utf8(archive), writer.size(), added, skipped,
+               failed);
+    }
+    return failed == 0 ? 0 : 1;
+}
+
+//  Print the selected archive entries with their metadata.
+static void list_entries(const Archive& arc, const std::vector<size_t>& entries, int ind,
+                         int ts)
+{
+    const auto sf = ind * ts;
+    const auto sf1 = (ind + 1) * ts;
+    for (const auto i : entries) {
+        const auto meta = arc.meta(i);
+        iprint(sf, "#{}: {}\n", i, meta.value(AR_NAME, ""));
+        for (const auto& [key, val] : meta.items()) {
+            if (key != AR_NAME) {
+                iprint(sf1, "{}: {}\n", key,
+                       val.is_string() ? val.get<std::string>() : val.dump());
+            }
+        }
+    }
+}
+
+//  Extract (or list) the selected archive entries.
+int run_unpack(const std::filesystem::path& archive, const std::filesystem::path& out_dir,
+               bool list, int verb, int ind, int ts)
+{
+    const auto sf = ind * ts;
+    const auto vdef = g_cfgs.verb.def;
+
+    std::filesystem::path apath;
+    std::string selector;
+    if (!split_archive_path(archive, apath, selector)) {
+        throw hmdq_error(fmt::format("Not an archive: \"{}\"", path_to_utf8(archive)));
+    }
+    const Archive arc(apath);
+    const auto entries = arc.select(selector);
+    if (list) {
+        list_entries(arc, entries, ind, ts);
+        return 0;
+    }
+
+    // print the execution header
+    print_header(HMDV_NAME, HMDV_VERSION, HMDV_DESCRIPTION, verb, ind, ts);
+    if (verb >= vdef)
+        oprint("\n");
+
+    std::filesystem::create_directories(out_dir);
+    std::unordered_set<std::string> names;
+    size_t failed = 0;
+    for (const auto i : entries) {
+        // only the file name, the metadata must not point out of the output directory
+        auto name = utf8_to_path(arc.meta(i).value(AR_NAME, "")).filename();
+        if (name.empty()) {
+            name = utf8_to_path(fmt::format("entry_{}", i));
+        }
+        if (!names.insert(path_to_utf8(name)).second) {
+            // the same name already extracted, add the entry index
+            name = utf8_to_path(fmt::format("{}_{}{}", path_to_utf8(name.stem()), i,
+                                            path_to_utf8(name.extension())));
+        }
+        const auto opath = out_dir / name;
+        std::ofstream fout(opath, std::ios::binary);
+        arc.with_data(i, [&fout](const char* first, const char* last) {
+            fout.write(first, last - first);
+        });
+        if (!fout) {
+            ++failed;
+            iprint(sf, "[Error] #{}: Cannot write file: \"{}\"\n", i,
+                   path_to_utf8(opath));
+            continue;
+        }
+        if (verb >= vdef) {
+            iprint(sf, "[Extracted] #{} -> {}\n", i, path_to_utf8(opath));
+        }
+    }
+
+    if (verb >= vdef) {
+        oprint("\n");
+        iprint(sf, "Extracted {} of {} entries from {}\n", entries.size() - failed,
+               arc.size(), path_to_utf8(apath));
+    }
+    return failed == 0 ? 0 : 1;
+}
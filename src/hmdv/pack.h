@@ -0,0 +1,30 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <filesystem>
+
+//  functions
+//------------------------------------------------------------------------------
+//  Append the data files from the batch input (see `collect_batch_files`) to the
+//  archive (created if it does not exist). Each entry gets the metadata header with
+//  the original file name, the HMD model and manufacturer, the hmdq version, the
+//  checksum and the timestamp. The files already in the archive (with the same
+//  checksum) are skipped. Return 0 if all files were packed (or skipped).
+int run_pack(const std::filesystem::path& archive, const std::filesystem::path& input,
+             int verb, int ind, int ts);
+
+//  Extract the archive entries selected by `archive` ("<archive>[#<selector>]") into
+//  `out_dir` under their original names, or only list them (with their metadata) if
+//  `list` is true. Return 0 if all entries were extracted.
+int run_unpack(const std::filesystem::path& archive, const std::filesystem::path& out_dir,
+               bool list, int verb, int ind, int ts);
@@ -0,0 +1,340 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#include "hmdv_misc.h"
+
+#include <common/config.h>
+#include <common/except.h>
+#include <common/fmthlp.h>
+#include <common/jkeys.h>
+#include <common/jtools.h>
+#include <common/oculus_props.h>
+#include <common/prtdata.h>
+#include <common/runstats.h>
+#include <common/tpool.h>
+#include <common/wintools.h>
+#include <hmdv/batch.h>
+#include <hmdv/hmdfix.h>
+#include <hmdv/stats.h>
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <map>
+#include <optional>
+
+//  locals
+//------------------------------------------------------------------------------
+static constexpr auto MM_IN_METER = 1000;
+static constexpr auto PRCT_IN_ONE = 100;
+
+//  OpenVR HMD model property
+static constexpr const char* OVR_MODEL_PROP = "Prop_ModelNumber_String";
+//  model name of the files without the model property
+static constexpr const char* UNKNOWN_MODEL = "unknown";
+
+//  files queued ahead of the aggregation (per worker thread)
+static constexpr size_t FILES_AHEAD = 4;
+
+//  percentiles reported for each metric
+static const std::vector<double> PERCENTILES = {0.05, 0.25, 0.5, 0.75, 0.95};
+
+//  typedefs
+//------------------------------------------------------------------------------
+//  Output format of the summary
+enum class sformat { csv, json };
+
+//  Geometry metric definition
+struct Metric {
+    const char* name;
+    // value path in the geometry section
+    json::json_pointer ptr;
+    // scale of the reported value (e.g. meters -> millimeters)
+    double scale;
+};
+
+//  Metric values extracted from one data file
+struct FileStats {
+    std::filesystem::path path;
+    std::string model;
+    std::vector<std::optional<double>> vals;
+    // error message (if the processing failed)
+    std::string msg;
+    bool failed = false;
+};
+
+//  Running aggregates of all metrics for one HMD model
+struct ModelStats {
+    size_t files = 0;
+    std::vector<RunningStats> metrics;
+};
+
+//  Model stats sorted by the model name
+using models_t = std::map<std::string, ModelStats>;
+
+//  functions
+//------------------------------------------------------------------------------
+//  Return the reported metrics (in the output order).
+static const std::vector<Metric>& get_metrics()
+{
+    static const auto root = json::json_pointer();
+    static const std::vector<Metric> metrics = {
+        {j_fov_hor, root / j_fov_tot / j_fov_hor, 1},
+        {j_fov_ver, root / j_fov_tot / j_fov_ver, 1},
+        {j_fov_diag, root / j_fov_tot / j_fov_diag, 1},
+        {j_overlap, root / j_fov_tot / j_overlap, 1},
+        {"ipd", root / j_view_geom / j_ipd, MM_IN_METER},
+        {"ham_area_left", root / j_ham_mesh / j_leye / j_ham_area, PRCT_IN_ONE},
+        {"ham_area_right", root / j_ham_mesh / j_reye / j_ham_area, PRCT_IN_ONE},
+        {"rec_rts_width", root / j_rec_rts / 0, 1},
+        {"rec_rts_height", root / j_rec_rts / 1, 1},
+    };
+    return metrics;
+}
+
+//  Return the sformat for its name ("csv", "json").
+static sformat get_sformat(const std::string& name)
+{
+    if (name == "csv") {
+        return sformat::csv;
+    } else if (name == "json") {
+        return sformat::json;
+    }
+    throw hmdq_error(fmt::format("Unknown stats format: \"{}\"", name));
+}
+
+//  Return the data file sections needed for the stats.
+static std::vector<std::string> stats_sections()
+{
+    // top level geometry is the old (pre v1.3.4) layout, fixed after loading
+    auto res = hmd_prop_sections();
+    res.insert(res.end(),
+               {fmt::format("/{}", j_misc), fmt::format("/{}", j_geometry),
+                fmt::format("/{}/{}", j_openvr, j_geometry),
+                fmt::format("/{}/{}", j_oculus, j_geometry)});
+    return res;
+}
+
+//  Return the HMD model name (OpenVR model number or Oculus product name).
+static std::string get_model(const json& jd)
+{
+    auto res = get_hmd_prop(jd, OVR_MODEL_PROP, oculus::Prop::ProductName_String);
+    return res.empty() ? UNKNOWN_MODEL : res;
+}
+
+//  Extract the model and the metric values from one data file. The first valid
+//  geometry (OpenVR, or Oculus default FOV) is used.
+static FileStats extract_stats(const std::filesystem::path& in_json,
+                               const std::vector<std::string>& sections)
+{
+    const auto& metrics = get_metrics();
+    FileStats res{in_json};
+    res.vals.resize(metrics.size());
+    try {
+        auto jd = read_json_sections(in_json, sections);
+        apply_all_relevant_fixes(jd);
+        res.model = get_model(jd);
+        const auto geoms = collect_geoms(jd);
+        if (!geoms.empty()) {
+            const auto& geom = *geoms.front();
+            for (size_t i = 0; i < metrics.size(); ++i) {
+                const auto& ptr = metrics[i].ptr;
+                if (geom.contains(ptr) && geom.at(ptr).is_number()) {
+                    res.vals[i] = geom.at(ptr).get<double>() * metrics[i].scale;
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        res.failed = true;
+        res.msg = e.what();
+    }
+    return res;
+}
+
+//  Add the metric values of one file into its model stats.
+static void add_file_stats(models_t& models, const FileStats& fst)
+{
+    auto& mst = models[fst.model];
+    if (mst.metrics.empty()) {
+        mst.metrics.assign(fst.vals.size(), RunningStats(PERCENTILES));
+    }
+    ++mst.files;
+    for (size_t i = 0; i < fst.vals.size(); ++i) {
+        if (fst.vals[i]) {
+            mst.metrics[i].add(*fst.vals[i]);
+        }
+    }
+}
+
+//  Return the percentile name (e.g. "p50").
+static std::string pct_name(double prob)
+{
+    return fmt::format("p{:g}", prob * PRCT_IN_ONE);
+}
+
+//  Return the CSV field (quoted if needed).
+static std::string csv_field(const std::string& val)
+{
+    if (val.find_first_of(",\"\r\n") == std::string::npos) {
+        return val;
+    }
+    std::string res = "\"";
+    for (const auto c : val) {
+        if (c == '"') {
+            res += '"';
+        }
+        res += c;
+    }
+    return res + '"';
+}
+
+//  Format the stats as CSV (one line per model and metric).
+static std::string format_csv(const models_t& models)
+{
+    const auto& metrics = get_metrics();
+    fmt::memory_buffer buf;
+    auto out = std::back_inserter(buf);
+    fmt::format_to(out, "model,files,metric,count,min,max,mean");
+    for (const auto prob : PERCENTILES) {
+        fmt::format_to(out, ",{}", pct_name(prob));
+    }
+    fmt::format_to(out, "\n");
+    for (const auto& [model, mst] : models) {
+        for (size_t i = 0; i < metrics.size(); ++i) {
+            const auto& rs = mst.metrics[i];
+            if (rs.count() == 0) {
+                continue;
+            }
+            fmt::format_to(out, "{},{},{},{},{},{},{}", csv_field(model), mst.files,
+                           metrics[i].name, rs.count(), rs.min(), rs.max(), rs.mean());
+            for (size_t j = 0; j < PERCENTILES.size(); ++j) {
+                fmt::format_to(out, ",{}", rs.quantile(j));
+            }
+            fmt::format_to(out, "\n");
+        }
+    }
+    return fmt::to_string(buf);
+}
+
+//  Return the stats as JSON.
+static json stats_to_json(const models_t& models, size_t nfiles, size_t failed)
+{
+    const auto& metrics = get_metrics();
+    json res;
+    res[j_hmdv_ver] = HMDV_VERSION;
+    res["files"] = nfiles;
+    res["failed"] = failed;
+    json jmodels = json::array();
+    for (const auto& [model, mst] : models) {
+        json jmetrics = json::object();
+        for (size_t i = 0; i < metrics.size(); ++i) {
+            const auto& rs = mst.metrics[i];
+            if (rs.count() == 0) {
+                continue;
+            }
+            json jm;
+            jm["count"] = rs.count();
+            jm["min"] = rs.min();
+            jm["max"] = rs.max();
+            jm["mean"] = rs.mean();
+            for (size_t j = 0; j < PERCENTILES.size(); ++j) {
+                jm[pct_name(PERCENTILES[j])] = rs.quantile(j);
+            }
+            jmetrics[metrics[i].name] = std::move(jm);
+        }
+        jmodels.push_back(
+            {{"model", model}, {"files", mst.files}, {"metrics", std::move(jmetrics)}});
+    }
+    res["models"] = std::move(jmodels);
+    return res;
+}
+
+//  Collect the geometry stats of all data files from the batch input.
+int run_stats(const std::filesystem::path& input, const std::filesystem::path& out_file,
+              const std::string& out_format, int jobs, int verb, int ind, int ts)
+{
+    const auto sf = ind * ts;
+    const auto format = get_sformat(out_format);
+    // the summary goes on the standard output if there is no output file, do not mix
+    // the messages in
+    const auto verbose = !out_file.empty() && verb >= g_cfgs.verb.def;
+    const auto start = std::chrono::steady_clock::now();
+
+    // print the execution header
+    if (verbose) {
+        print_header(HMDV_NAME, HMDV_VERSION, HMDV_DESCRIPTION, verb, ind, ts);
+        oprint("\n");
+    }
+
+    // keep the input archive open for the whole run, the entries are read from it
+    const auto parc = open_batch_archive(input);
+    const auto files = collect_batch_files(input);
+    const auto sections = stats_sections();
+    ThreadPool pool(jobs >= 0 ? jobs : 0);
+
+    // only a few files are in flight at a time, their values are aggregated in the
+    // input order and dropped
+    models_t models;
+    size_t failed = 0;
+    std::deque<std::future<FileStats>> pending;
+    const auto ahead = pool.size() * FILES_AHEAD;
+    auto next = files.cbegin();
+    while (next != files.cend() || !pending.empty()) {
+        for (; next != files.cend() && pending.size() < ahead; ++next) {
+            const auto& fpath = *next;
+            pending.push_back(pool.submit(
+                [&fpath, &sections]() { return extract_stats(fpath, sections); }));
+        }
+        const auto fst = pending.front().get();
+        pending.pop_front();
+        if (fst.failed) {
+            ++failed;
+            if (verbose) {
+                iprint(sf, "[Error] {}: {}\n", path_to_utf8(fst.path), fst.msg);
+            }
+            continue;
+        }
+        add_file_stats(models, fst);
+    }
+
+    // write the summary
+    if (format == sformat::csv) {
+        const auto csv = format_csv(models);
+        if (out_file.empty()) {
+            oprint("{}", csv);
+        } else {
+            std::ofstream fo(out_file, std::ios::binary);
+            fo.write(csv.data(), csv.size());
+        }
+    } else {
+        const auto jd = stats_to_json(models, files.size(), failed);
+        if (out_file.empty()) {
+            oprint("{}\n", jd.dump(g_cfgs.json_indent));
+        } else {
+            write_json(out_file, jd, g_cfgs.json_indent);
+        }
+    }
+
+    if (verbose) {
+        const std::chrono::duration<double> elapsed
+            = std::chrono::steady_clock::now() - start;
+        if (failed > 0) {
+            oprint("\n");
+        }
+        iprint(sf,
+               "Processed {} files ({} models) in {:.1f} s on {} threads: {} failed\n",
+               files.size(), models.size(), elapsed.count(), pool.size(), failed);
+    }
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,27 @@
+/******************************************************************************
+ * HMDQ Tools - tools for VR headsets and other hardware introspection        *
+ * https://github.com/risa2000/hmdq                                           *
+ *                                                                            *
+ * Copyright (c) 2026, Richard Musil. All rights reserved.                    *
+ *                                                                            *
+ * This source code is licensed under the BSD 3-Clause "New" or "Revised"     *
+ * License found in the LICENSE file in the root directory of this project.   *
+ * SPDX-License-Identifier: BSD-3-Clause                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+//  functions
+//------------------------------------------------------------------------------
+//  Collect the geometry statistics of all data files from the batch input (see
+//  `collect_batch_files`) on `jobs` worker threads (0 = one per hardware thread). The
+//  files are grouped by the HMD model and for each metric (total FOV, overlap, IPD,
+//  HAM area and the recommended render target size) only the running aggregates
+//  (count, min, max, mean and percentiles) are kept in memory. Write the summary in
+//  `out_format` ("csv" or "json") into `out_file`, or on the standard output if it is
+//  empty. Return 0 if all files were processed.
+int run_stats(const std::filesystem::path& input, const std::filesystem::path& out_file,
+              const std::string& out_format, int jobs, int verb, int ind, int ts);